@@ -0,0 +1,74 @@
+#include "bench.hpp"
+
+#include "tiara/core/event/async_dispatcher.hpp"
+
+#include <cstddef>
+#include <vector>
+
+// prints one json object per line: {"benchmark": ..., "params": {...}, "iterations": ..., "ns_per_op": ..., "allocations_per_op": ...}
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+};
+
+struct SyncEventHandler: tiara::core::event::Handler<Event> {
+    bool handle(const Event&, tiara::core::event::sync_tag_t) override {
+        return false;
+    }
+};
+
+struct AsyncEventHandler: tiara::core::event::AsyncHandler<Event> {
+    boost::asio::awaitable<bool, boost::asio::any_io_executor> handle(const Event&) override {
+        co_return false;
+    }
+};
+
+struct EventDispatcher: tiara::core::event::DefaultAsyncDispatcher<boost::asio::any_io_executor, Event> {
+    using tiara::core::event::DefaultAsyncDispatcher<boost::asio::any_io_executor, Event>::DefaultAsyncDispatcher;
+    using tiara::core::event::DefaultAsyncDispatcher<boost::asio::any_io_executor, Event>::dispatch;
+};
+
+static constexpr std::size_t events_per_run = 200'000;
+
+void bench_dispatch(std::size_t sync_count, std::size_t async_count) {
+    boost::asio::io_context io_context;
+    EventDispatcher dispatcher{io_context.get_executor()};
+    std::vector<SyncEventHandler> sync_handlers(sync_count);
+    std::vector<AsyncEventHandler> async_handlers(async_count);
+    for (auto& handler: sync_handlers) dispatcher.start_dispatch(handler);
+    for (auto& handler: async_handlers) dispatcher.start_dispatch(handler);
+
+    tiara::bench::Measurement measurement;
+    boost::asio::co_spawn(
+        io_context,
+        [&]() -> boost::asio::awaitable<void> {
+            // warm up asio's per-thread frame cache and the dispatcher buffers
+            co_await dispatcher.dispatch(Event{}, tiara::core::event::reducers::any_of{});
+            std::size_t consumed = 0;
+            auto time_before = std::chrono::steady_clock::now();
+            auto allocations_before = tiara::bench::allocation_count.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < events_per_run; i++) {
+                consumed += co_await dispatcher.dispatch(Event{}, tiara::core::event::reducers::any_of{});
+            }
+            auto allocations_after = tiara::bench::allocation_count.load(std::memory_order_relaxed);
+            auto time_after = std::chrono::steady_clock::now();
+            measurement = {
+                events_per_run,
+                std::chrono::duration<double, std::nano>(time_after - time_before).count() / events_per_run,
+                static_cast<double>(allocations_after - allocations_before) / events_per_run
+            };
+        },
+        boost::asio::detached
+    );
+    io_context.run();
+    tiara::bench::report("async_dispatch", {{"sync_handlers", sync_count}, {"async_handlers", async_count}}, measurement);
+}
+
+int main() {
+    for (std::size_t sync_count: {1, 10, 100}) {
+        bench_dispatch(sync_count, 0);
+        bench_dispatch(sync_count, 1);
+    }
+    bench_dispatch(0, 1);
+    bench_dispatch(0, 10);
+}
@@ -0,0 +1,74 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/dispatcher.hpp"
+
+#include <chrono>
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+    int value;
+};
+
+struct EventHandler: tiara::core::event::Handler<Event> {
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        sink += event.value;
+        return false;
+    }
+
+    unsigned sink = 0;
+};
+
+struct BatchEventHandler: EventHandler {
+    void handle_batch(std::span<const Event> events, tiara::core::event::sync_tag_t) override {
+        unsigned sum = 0;
+        for (const Event& event: events) sum += event.value;
+        sink += sum;
+    }
+};
+
+struct EventDispatcher: tiara::core::event::DefaultDispatcher<Event> {
+    using tiara::core::event::DefaultDispatcher<Event>::dispatch;
+    using tiara::core::event::DefaultDispatcher<Event>::defer;
+    using tiara::core::event::DefaultDispatcher<Event>::flush_deferred;
+};
+
+template <typename Hdlr>
+void run(const char* name, std::size_t handler_count, std::size_t batch_size, std::size_t iterations) {
+    std::vector<Hdlr> handlers(handler_count);
+    EventDispatcher dispatcher;
+    for (auto& handler: handlers) dispatcher.start_dispatch(handler);
+
+    auto time_before = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+        if (batch_size == 0) {
+            dispatcher.dispatch(Event{{}, static_cast<int>(i)}, tiara::core::event::reducers::any_of{});
+            continue;
+        }
+        dispatcher.defer(Event{{}, static_cast<int>(i)});
+        if ((i + 1) % batch_size == 0) dispatcher.flush_deferred();
+    }
+    dispatcher.flush_deferred();
+    auto time_after = std::chrono::steady_clock::now();
+
+    unsigned checksum = 0;
+    for (auto& handler: handlers) checksum += handler.sink;
+    spdlog::info(
+        "{} ({} handlers, batch size {}): {:.2f} ns/event (checksum {})",
+        name,
+        handler_count,
+        batch_size,
+        std::chrono::duration<double, std::nano>(time_after - time_before).count() / iterations,
+        checksum
+    );
+}
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    constexpr std::size_t handler_count = 16;
+    constexpr std::size_t iterations = 10'000'000;
+    run<EventHandler>("dispatch", handler_count, 0, iterations);
+    for (std::size_t batch_size: {1, 16, 256}) {
+        run<EventHandler>("default handle_batch", handler_count, batch_size, iterations);
+        run<BatchEventHandler>("overridden handle_batch", handler_count, batch_size, iterations);
+    }
+}
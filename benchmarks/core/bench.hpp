@@ -0,0 +1,75 @@
+#ifndef TIARA_BENCHMARKS_CORE_BENCH
+#define TIARA_BENCHMARKS_CORE_BENCH
+
+#include "fmt/format.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <initializer_list>
+#include <new>
+#include <string_view>
+#include <utility>
+
+// counts every global allocation, include from a single translation unit of each benchmark program
+
+namespace tiara::bench {
+    static inline std::atomic<std::size_t> allocation_count{0};
+
+    struct Measurement {
+        std::size_t iterations;
+        double ns_per_op;
+        double allocations_per_op;
+    };
+
+    /**
+     *  @brief time iterations calls of f(i), excluding the time and allocations of setup done before
+     */
+    template <typename F>
+    Measurement measure(std::size_t iterations, F&& f) {
+        auto allocations_before = allocation_count.load(std::memory_order_relaxed);
+        auto time_before = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < iterations; i++) f(i);
+        auto time_after = std::chrono::steady_clock::now();
+        auto allocations_after = allocation_count.load(std::memory_order_relaxed);
+        return {
+            iterations,
+            std::chrono::duration<double, std::nano>(time_after - time_before).count() / iterations,
+            static_cast<double>(allocations_after - allocations_before) / iterations
+        };
+    }
+
+    /**
+     *  @brief print measurement as a single json line to stdout
+     */
+    void report(std::string_view benchmark, std::initializer_list<std::pair<std::string_view, std::size_t>> params, const Measurement& measurement) {
+        std::string line = fmt::format("{{\"benchmark\": \"{}\", \"params\": {{", benchmark);
+        bool first = true;
+        for (auto& [name, value]: params) {
+            line += fmt::format("{}\"{}\": {}", first ? "" : ", ", name, value);
+            first = false;
+        }
+        line += fmt::format(
+            "}}, \"iterations\": {}, \"ns_per_op\": {:.3f}, \"allocations_per_op\": {:.4f}}}\n",
+            measurement.iterations, measurement.ns_per_op, measurement.allocations_per_op
+        );
+        std::fputs(line.c_str(), stdout);
+    }
+}
+
+void* operator new(std::size_t size) {
+    tiara::bench::allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size)) return ptr;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,52 @@
+#include "bench.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/dispatcher.hpp"
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+    int value;
+};
+
+struct EventHandler: tiara::core::event::Handler<Event> {
+    EventHandler(bool consume): consume{consume} {}
+
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        sink += event.value;
+        return consume;
+    }
+
+    bool consume;
+    int sink = 0;
+};
+
+struct EventDispatcher: tiara::core::event::DefaultDispatcher<Event> {
+    using tiara::core::event::DefaultDispatcher<Event>::dispatch;
+};
+
+template <typename F>
+void run(const char* name, std::size_t iterations, F&& f) {
+    auto measurement = tiara::bench::measure(iterations, [&f](std::size_t i){ f(static_cast<int>(i)); });
+    spdlog::info("{}: {:.2f} ns/dispatch, {:.4f} allocations/dispatch", name, measurement.ns_per_op, measurement.allocations_per_op);
+}
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    constexpr std::size_t handler_count = 64;
+    constexpr std::size_t iterations = 1'000'000;
+
+    std::vector<std::unique_ptr<EventHandler>> handlers;
+    handlers.reserve(handler_count);
+    EventDispatcher dispatcher;
+    for (std::size_t i = 0; i < handler_count; i++) {
+        // only the middle handler consumes the event
+        handlers.emplace_back(std::make_unique<EventHandler>(i == handler_count / 2));
+        dispatcher.start_dispatch(*handlers.back());
+    }
+
+    run("fold (init, op)", iterations, [&dispatcher](int i){ return dispatcher.dispatch(Event{{}, i}, 0); });
+    run("reducers::any_of", iterations, [&dispatcher](int i){ return dispatcher.dispatch(Event{{}, i}, tiara::core::event::reducers::any_of{}); });
+    run("reducers::all_of", iterations, [&dispatcher](int i){ return dispatcher.dispatch(Event{{}, i}, tiara::core::event::reducers::all_of{}); });
+    run("reducers::first_consumer", iterations, [&dispatcher](int i){ return dispatcher.dispatch(Event{{}, i}, tiara::core::event::reducers::first_consumer{}); });
+}
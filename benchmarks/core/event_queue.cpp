@@ -0,0 +1,74 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/event_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+struct PosEvent: tiara::core::event::Event {
+    using RetType = bool;
+    int x;
+    int y;
+};
+
+struct CloseEvent: tiara::core::event::Event {
+    using RetType = bool;
+};
+
+void run(std::size_t producer_count, std::size_t events_per_producer, std::size_t capacity) {
+    tiara::core::event::EventQueue<PosEvent, CloseEvent> queue{capacity};
+    std::atomic<bool> start{false};
+    std::vector<std::thread> producers;
+    producers.reserve(producer_count);
+    for (std::size_t p = 0; p < producer_count; p++) {
+        producers.emplace_back(
+            [&queue, &start, events_per_producer, p](){
+                while (!start.load(std::memory_order_acquire));
+                for (std::size_t i = 0; i < events_per_producer; i++) {
+                    while (!queue.post(PosEvent{{}, static_cast<int>(p), static_cast<int>(i)})) std::this_thread::yield();
+                }
+            }
+        );
+    }
+
+    std::size_t total = producer_count * events_per_producer;
+    std::size_t consumed = 0;
+    std::size_t batches = 0;
+    long long checksum = 0;
+    auto time_before = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    while (consumed < total) {
+        auto count = queue.drain(
+            [&checksum](const auto& event) {
+                if constexpr (std::same_as<std::remove_cvref_t<decltype(event)>, PosEvent>) checksum += event.y;
+            }
+        );
+        if (count == 0) std::this_thread::yield();
+        else batches++;
+        consumed += count;
+    }
+    auto time_after = std::chrono::steady_clock::now();
+    for (auto& producer: producers) producer.join();
+
+    auto seconds = std::chrono::duration<double>(time_after - time_before).count();
+    spdlog::info(
+        "producers: {}, capacity: {}: {:.2f} Mevents/s, {:.1f} events/batch (checksum {})",
+        producer_count,
+        queue.capacity(),
+        total / seconds / 1e6,
+        static_cast<double>(total) / batches,
+        checksum
+    );
+}
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    constexpr std::size_t events = 4'000'000;
+    for (std::size_t producer_count: {1, 2, 4, 8}) {
+        run(producer_count, events / producer_count, 1024);
+    }
+    run(4, events / 4, 64);
+    run(4, events / 4, 65536);
+}
@@ -0,0 +1,196 @@
+#include "bench.hpp"
+
+#include "tiara/core/event/dispatcher.hpp"
+#include "tiara/core/event/event_bus.hpp"
+#include "tiara/core/event/managed_handler.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// prints one json object per line: {"benchmark": ..., "params": {...}, "iterations": ..., "ns_per_op": ..., "allocations_per_op": ...}
+
+template <std::size_t PayloadSize>
+struct PayloadEvent: tiara::core::event::Event {
+    using RetType = bool;
+    std::array<std::byte, PayloadSize> payload;
+};
+
+template <std::size_t PayloadSize>
+struct PayloadEventHandler: tiara::core::event::Handler<PayloadEvent<PayloadSize>> {
+    bool handle(const PayloadEvent<PayloadSize>& event, tiara::core::event::sync_tag_t) override {
+        sink += static_cast<unsigned>(event.payload.front()) + static_cast<unsigned>(event.payload.back());
+        return false;
+    }
+
+    unsigned sink = 0;
+};
+
+template <std::size_t PayloadSize>
+struct PayloadEventDispatcher: tiara::core::event::DefaultDispatcher<PayloadEvent<PayloadSize>> {
+    using tiara::core::event::DefaultDispatcher<PayloadEvent<PayloadSize>>::dispatch;
+};
+
+using Event = PayloadEvent<8>;
+using EventHandler = PayloadEventHandler<8>;
+using EventDispatcher = PayloadEventDispatcher<8>;
+
+struct DelegatingEventDispatcher: tiara::core::event::DelegatingSharedDispatcher<EventDispatcher, Event> {
+    DelegatingEventDispatcher(std::shared_ptr<EventDispatcher> dispatcher):
+        tiara::core::event::DelegatingSharedDispatcher<EventDispatcher, Event>{std::move(dispatcher)} {}
+};
+
+struct EventBus: tiara::core::event::EventBus {
+    using tiara::core::event::EventBus::dispatch;
+};
+
+using KeepAliveEventDispatcher = tiara::core::event::KeepAliveDispatcher<Event, boost::asio::any_io_executor, EventHandler, EventDispatcher>;
+using ManagedEventHandler = tiara::core::event::ManagedHandler<Event, boost::asio::any_io_executor, EventHandler>;
+
+static constexpr std::size_t handler_counts[] = {1, 10, 100, 1'000, 10'000, 100'000};
+// keeps every configuration at roughly the same number of handler calls
+static constexpr std::size_t handler_calls_per_run = 20'000'000;
+
+template <std::size_t PayloadSize>
+void bench_dispatch(std::size_t handler_count) {
+    std::vector<PayloadEventHandler<PayloadSize>> handlers(handler_count);
+    PayloadEventDispatcher<PayloadSize> dispatcher;
+    for (auto& handler: handlers) dispatcher.start_dispatch(handler);
+    PayloadEvent<PayloadSize> event{};
+    auto measurement = tiara::bench::measure(
+        std::max<std::size_t>(handler_calls_per_run / handler_count, 100),
+        [&dispatcher, &event](std::size_t i) {
+            event.payload.front() = static_cast<std::byte>(i);
+            dispatcher.dispatch(event, tiara::core::event::reducers::any_of{});
+        }
+    );
+    tiara::bench::report("dispatch", {{"handlers", handler_count}, {"payload_bytes", PayloadSize}}, measurement);
+}
+
+void bench_event_bus_dispatch(std::size_t handler_count) {
+    std::vector<EventHandler> handlers(handler_count);
+    EventBus bus;
+    for (auto& handler: handlers) bus.start_dispatch(handler);
+    Event event{};
+    auto measurement = tiara::bench::measure(
+        std::max<std::size_t>(handler_calls_per_run / handler_count, 100),
+        [&bus, &event](std::size_t i) {
+            event.payload.front() = static_cast<std::byte>(i);
+            bus.dispatch(event, tiara::core::event::reducers::any_of{});
+        }
+    );
+    tiara::bench::report("event_bus_dispatch", {{"handlers", handler_count}, {"payload_bytes", 8}}, measurement);
+}
+
+void bench_dispatch_churn(std::size_t handler_count, std::size_t churn_per_1000_events) {
+    std::vector<EventHandler> handlers(handler_count * 2);
+    EventDispatcher dispatcher;
+    std::vector<tiara::core::event::Subscription<Event>> subscriptions;
+    subscriptions.reserve(handler_count);
+    for (std::size_t i = 0; i < handler_count; i++) subscriptions.push_back(dispatcher.subscribe(handlers[i]));
+    std::size_t churned = 0;
+    auto measurement = tiara::bench::measure(
+        std::max<std::size_t>(handler_calls_per_run / handler_count, 1000),
+        [&](std::size_t i) {
+            // replace the oldest subscription with a handler not currently subscribed
+            for (std::size_t target = (i + 1) * churn_per_1000_events / 1000; churned < target; churned++) {
+                std::size_t slot = churned % handler_count;
+                dispatcher.unsubscribe(subscriptions[slot]);
+                subscriptions[slot] = dispatcher.subscribe(handlers[(churned + handler_count) % handlers.size()]);
+            }
+            dispatcher.dispatch(Event{}, tiara::core::event::reducers::any_of{});
+        }
+    );
+    tiara::bench::report("dispatch_churn", {{"handlers", handler_count}, {"churn_per_1000_events", churn_per_1000_events}}, measurement);
+}
+
+void bench_subscribe_unsubscribe(std::size_t handler_count) {
+    std::vector<EventHandler> handlers(handler_count + 1);
+    EventDispatcher dispatcher;
+    for (std::size_t i = 0; i < handler_count; i++) dispatcher.start_dispatch(handlers[i]);
+    auto measurement = tiara::bench::measure(
+        1'000'000,
+        [&](std::size_t) {
+            dispatcher.start_dispatch(handlers.back());
+            dispatcher.stop_dispatch(handlers.back());
+        }
+    );
+    tiara::bench::report("default_subscribe_unsubscribe", {{"handlers", handler_count}}, measurement);
+}
+
+void bench_delegating_subscribe_unsubscribe(std::size_t handler_count) {
+    std::vector<EventHandler> handlers(handler_count + 1);
+    auto dispatcher = std::make_shared<EventDispatcher>();
+    DelegatingEventDispatcher delegating_dispatcher{dispatcher};
+    for (std::size_t i = 0; i < handler_count; i++) delegating_dispatcher.start_dispatch(handlers[i]);
+    auto measurement = tiara::bench::measure(
+        1'000'000,
+        [&](std::size_t) {
+            delegating_dispatcher.start_dispatch(handlers.back());
+            delegating_dispatcher.stop_dispatch(handlers.back());
+        }
+    );
+    tiara::bench::report("delegating_subscribe_unsubscribe", {{"handlers", handler_count}}, measurement);
+}
+
+void bench_keep_alive_subscribe_unsubscribe(std::size_t handler_count) {
+    KeepAliveEventDispatcher dispatcher;
+    for (std::size_t i = 0; i < handler_count; i++) dispatcher.start_dispatch(std::make_shared<EventHandler>());
+    auto handler = std::make_shared<EventHandler>();
+    auto measurement = tiara::bench::measure(
+        1'000'000,
+        [&](std::size_t) {
+            dispatcher.start_dispatch(handler);
+            dispatcher.stop_dispatch(handler);
+        }
+    );
+    tiara::bench::report("keep_alive_subscribe_unsubscribe", {{"handlers", handler_count}}, measurement);
+}
+
+void bench_managed_handler(std::size_t dispatcher_count) {
+    std::vector<std::shared_ptr<EventDispatcher>> dispatchers;
+    for (std::size_t i = 0; i < dispatcher_count; i++) dispatchers.push_back(std::make_shared<EventDispatcher>());
+    std::vector<std::shared_ptr<tiara::core::event::Dispatcher<Event>>> sync_dispatchers{dispatchers.begin(), dispatchers.end()};
+
+    auto handler = std::make_shared<ManagedEventHandler>();
+    auto subscribe_measurement = tiara::bench::measure(
+        1'000'000 / dispatcher_count,
+        [&](std::size_t) {
+            for (auto& dispatcher: sync_dispatchers) handler->subscribe(dispatcher);
+            for (auto& dispatcher: sync_dispatchers) handler->unsubscribe(dispatcher);
+        }
+    );
+    tiara::bench::report("managed_subscribe_unsubscribe", {{"dispatchers", dispatcher_count}}, subscribe_measurement);
+
+    auto destroy_measurement = tiara::bench::measure(
+        1'000'000 / dispatcher_count,
+        [&](std::size_t) {
+            auto handler = std::make_shared<ManagedEventHandler>();
+            for (auto& dispatcher: sync_dispatchers) handler->subscribe(dispatcher);
+            // destruction unsubscribes from every dispatcher still alive
+        }
+    );
+    tiara::bench::report("managed_create_subscribe_destroy", {{"dispatchers", dispatcher_count}}, destroy_measurement);
+}
+
+int main() {
+    for (std::size_t handler_count: handler_counts) {
+        bench_dispatch<8>(handler_count);
+        bench_dispatch<64>(handler_count);
+        bench_dispatch<512>(handler_count);
+        bench_event_bus_dispatch(handler_count);
+    }
+    for (std::size_t churn: {0, 1, 10, 100, 1000}) {
+        bench_dispatch_churn(100, churn);
+        bench_dispatch_churn(10'000, churn);
+    }
+    for (std::size_t handler_count: handler_counts) {
+        bench_subscribe_unsubscribe(handler_count);
+        bench_delegating_subscribe_unsubscribe(handler_count);
+        bench_keep_alive_subscribe_unsubscribe(handler_count);
+    }
+    for (std::size_t dispatcher_count: {1, 10, 100}) {
+        bench_managed_handler(dispatcher_count);
+    }
+}
@@ -0,0 +1,89 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/dispatcher.hpp"
+#include "tiara/core/event/static_dispatcher.hpp"
+
+#include <chrono>
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+    int value;
+};
+
+struct EventHandler final: tiara::core::event::Handler<Event> {
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        sink += event.value;
+        return false;
+    }
+
+    unsigned sink = 0;
+};
+
+struct EventDispatcher: tiara::core::event::DefaultDispatcher<Event> {
+    using tiara::core::event::DefaultDispatcher<Event>::dispatch;
+};
+
+template <typename... Hdlrs>
+struct StaticEventDispatcher: tiara::core::event::StaticDispatcher<Event, Hdlrs...> {
+    using tiara::core::event::StaticDispatcher<Event, Hdlrs...>::dispatch;
+};
+
+static_assert(
+    tiara::core::event::DispatcherType<StaticEventDispatcher<EventHandler>, EventHandler, Event, boost::asio::any_io_executor>,
+    "StaticDispatcher should satisfy DispatcherType"
+);
+
+template <typename Dispatch, typename Checksum>
+void run(const char* name, std::size_t handler_count, std::size_t iterations, Dispatch& dispatcher, Checksum checksum) {
+    auto time_before = std::chrono::steady_clock::now();
+    bool consumed = false;
+    for (std::size_t i = 0; i < iterations; i++) {
+        consumed |= dispatcher.dispatch(Event{{}, static_cast<int>(i)}, tiara::core::event::reducers::any_of{});
+    }
+    auto time_after = std::chrono::steady_clock::now();
+    spdlog::info(
+        "{} ({} handlers): {:.2f} ns/dispatch (checksum {}{})",
+        name,
+        handler_count,
+        std::chrono::duration<double, std::nano>(time_after - time_before).count() / iterations,
+        checksum(),
+        consumed ? ", consumed" : ""
+    );
+}
+
+template <std::size_t I>
+using IndexedEventHandler = EventHandler;
+
+template <std::size_t... Is>
+void run_with(std::index_sequence<Is...>, std::size_t iterations) {
+    constexpr std::size_t handler_count = sizeof...(Is);
+
+    std::array<EventHandler, handler_count> handlers;
+    EventDispatcher dynamic_dispatcher;
+    for (auto& handler: handlers) dynamic_dispatcher.start_dispatch(handler);
+    run(
+        "DefaultDispatcher", handler_count, iterations, dynamic_dispatcher,
+        [&handlers](){
+            unsigned sum = 0;
+            for (auto& handler: handlers) sum += handler.sink;
+            return sum;
+        }
+    );
+
+    StaticEventDispatcher<IndexedEventHandler<Is>...> static_dispatcher;
+    run(
+        "StaticDispatcher", handler_count, iterations, static_dispatcher,
+        [&static_dispatcher](){
+            return (static_dispatcher.template handler<Is>().sink + ...);
+        }
+    );
+}
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    constexpr std::size_t iterations = 10'000'000;
+    run_with(std::make_index_sequence<1>{}, iterations);
+    run_with(std::make_index_sequence<4>{}, iterations);
+    run_with(std::make_index_sequence<16>{}, iterations);
+    run_with(std::make_index_sequence<64>{}, iterations / 4);
+}
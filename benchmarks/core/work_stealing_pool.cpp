@@ -0,0 +1,46 @@
+#include "bench.hpp"
+
+#include "tiara/core/task/pool.hpp"
+
+#include <atomic>
+#include <latch>
+
+// prints one json object per line, see event_suite.cpp
+
+template <typename Executor>
+void spawn_tree(const Executor& executor, int depth, std::latch& done) {
+    if (depth == 0) {
+        done.count_down();
+        return;
+    }
+    boost::asio::post(executor, [executor, depth, &done](){ spawn_tree(executor, depth - 1, done); });
+    boost::asio::post(executor, [executor, depth, &done](){ spawn_tree(executor, depth - 1, done); });
+}
+
+template <typename Executor>
+tiara::bench::Measurement measure_tree(const Executor& executor, int depth, std::size_t iterations) {
+    return tiara::bench::measure(
+        iterations,
+        [&executor, depth](std::size_t) {
+            std::latch done{std::ptrdiff_t{1} << depth};
+            boost::asio::post(executor, [&executor, depth, &done](){ spawn_tree(executor, depth, done); });
+            done.wait();
+        }
+    );
+}
+
+int main() {
+    constexpr int depth = 16;
+    constexpr std::size_t iterations = 20;
+    for (std::size_t worker_count: {1, 2, 4, 8}) {
+        {
+            tiara::core::task::WorkStealingPool pool{worker_count};
+            tiara::bench::report("work_stealing_pool_tree", {{"workers", worker_count}, {"depth", depth}}, measure_tree(pool.get_executor(), depth, iterations));
+        }
+        {
+            boost::asio::thread_pool pool{worker_count};
+            tiara::bench::report("asio_thread_pool_tree", {{"workers", worker_count}, {"depth", depth}}, measure_tree(pool.get_executor(), depth, iterations));
+            pool.join();
+        }
+    }
+}
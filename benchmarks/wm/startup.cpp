@@ -0,0 +1,39 @@
+#include "../core/bench.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/core.hpp"
+#include "tiara/wm/wm.hpp"
+
+#include <chrono>
+#include <string>
+
+// time to first frame, each phase of the startup report is printed as its own line with a single iteration
+
+int main() {
+    spdlog::set_level(spdlog::level::warn);
+    tiara::core::application_name = "Tiara Startup Benchmark";
+    tiara::core::application_version = {1, 0, 0};
+    auto tiara_raii = tiara::core::Tiara<tiara::wm::WMExtension>::init_ext();
+    {
+        tiara::wm::Window window{{1280, 720}, "tiara startup benchmark"};
+        auto draw_handler = tiara::core::event::make_function_handler<tiara::common::events::DrawEvent>(
+            [](const tiara::common::events::DrawEvent& event){
+                event.canvas->clear(SK_ColorBLACK);
+                return true;
+            }
+        );
+        window.start_dispatch(draw_handler);
+        window.draw();
+        window.stop();
+    }
+
+    for (const auto& phase: tiara::core::startup_report().phases()) {
+        auto time = phase.duration.count() == 0 ? phase.start : phase.duration;
+        tiara::bench::report(
+            "startup/" + phase.name,
+            {{"depth", phase.depth}},
+            {1, std::chrono::duration<double, std::nano>(time).count(), 0}
+        );
+    }
+}
@@ -4,11 +4,23 @@
 #include "tiara/core/event/eventtype.hpp"
 
 #include "skia/core/SkCanvas.h"
+#include "skia/core/SkRegion.h"
 
 namespace tiara::common::events {
     struct DrawEvent: core::event::Event {
         using RetType = bool;
         SkCanvas* canvas;
+        // the part of canvas being redrawn, canvas is clipped to it, null if all of it is
+        const SkRegion* damage = nullptr;
+        // damage reported for the next frame
+        SkRegion* next_damage = nullptr;
+
+        /**
+         *  @brief report rect as changed after this frame, e.g. by an animation, so the window draws it again
+         */
+        void invalidate(const SkIRect& rect) const {
+            if (next_damage) next_damage->op(rect, SkRegion::kUnion_Op);
+        }
     };
 }
 
@@ -3,12 +3,28 @@
 
 #include "tiara/core/event/event.hpp"
 #include "tiara/core/extension/extension.hpp"
+#include "tiara/core/startup.hpp"
 #include "tiara/core/utilities/concept_invocable.hpp"
+#include "tiara/core/utilities/disk_cache.hpp"
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <mutex>
 #include <ranges>
 #include <set>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace tiara::core::detail {
     static inline uint32_t vulkan_api_version = VK_API_VERSION_1_2;
@@ -63,7 +79,8 @@ namespace tiara::core {
 }
 
 namespace tiara::core::detail {
-    static inline auto logger = spdlog::stdout_color_st("tiara::core");
+    // extensions may log from the threads initializing them
+    static inline auto logger = spdlog::stdout_color_mt("tiara::core");
 
     static inline std::optional<Context> ctx;
 }
@@ -99,11 +116,171 @@ namespace tiara::core {
     static inline std::vector<std::string> vulkan_instance_layers;
     static inline std::vector<std::string> vulkan_instance_extensions;
 
+    /**
+     *  @brief directory to persist physical device capabilities in between runs, they are queried every run if empty
+     */
+    static inline std::optional<std::filesystem::path> device_capabilities_cache_directory;
+
+    /**
+     *  @brief what device and queue selection needs to know about a physical device, queried once per instance
+     */
+    struct PhysicalDeviceCapabilities {
+        vk::PhysicalDeviceProperties properties;
+        // sorted, interned for the lifetime of the process
+        std::vector<std::string_view> extensions;
+        std::vector<vk::QueueFamilyProperties> queue_families;
+        vk::PhysicalDeviceMemoryProperties memory;
+
+        bool has_extension(std::string_view name) const {
+            return std::ranges::binary_search(extensions, name);
+        }
+
+        template <std::ranges::input_range R> requires std::convertible_to<std::ranges::range_reference_t<R>, std::string_view>
+        bool has_extensions(const R& names) const {
+            return std::ranges::all_of(names, [this](std::string_view name) { return has_extension(name); });
+        }
+    };
+}
+
+namespace tiara::core::detail {
+    static_assert(std::is_trivially_copyable_v<vk::QueueFamilyProperties> && std::is_trivially_copyable_v<vk::PhysicalDeviceMemoryProperties>);
+
+    static inline std::mutex device_capabilities_mutex;
+    static inline std::unordered_map<VkPhysicalDevice, PhysicalDeviceCapabilities> device_capabilities;
+    static inline std::unordered_set<std::string> interned_extension_names;
+
+    std::string_view _intern_extension_name(std::string_view name) {
+        return *interned_extension_names.emplace(name).first;
+    }
+
+    /**
+     *  @brief cache key of a device and driver, a driver update or different api version misses
+     */
+    std::vector<std::byte> _device_capabilities_cache_key(const vk::PhysicalDeviceProperties& properties) {
+        std::string key = "tiara device capabilities 1";
+        auto append = [&key](const auto& value) { key.append(reinterpret_cast<const char*>(&value), sizeof(value)); };
+        append(properties.vendorID);
+        append(properties.deviceID);
+        append(properties.driverVersion);
+        append(properties.apiVersion);
+        key.append(reinterpret_cast<const char*>(properties.pipelineCacheUUID.data()), properties.pipelineCacheUUID.size());
+        key.append(properties.deviceName.data());
+        std::vector<std::byte> result(key.size());
+        std::memcpy(result.data(), key.data(), key.size());
+        return result;
+    }
+
+    std::vector<std::byte> _serialize_device_capabilities(const PhysicalDeviceCapabilities& capabilities) {
+        std::vector<std::byte> result;
+        auto append = [&result](const void* data, std::size_t size) {
+            auto bytes = static_cast<const std::byte*>(data);
+            result.insert(result.end(), bytes, bytes + size);
+        };
+        uint32_t extension_count = static_cast<uint32_t>(capabilities.extensions.size());
+        append(&extension_count, sizeof(extension_count));
+        for (auto extension: capabilities.extensions) {
+            uint32_t length = static_cast<uint32_t>(extension.size());
+            append(&length, sizeof(length));
+            append(extension.data(), extension.size());
+        }
+        uint32_t queue_family_count = static_cast<uint32_t>(capabilities.queue_families.size());
+        append(&queue_family_count, sizeof(queue_family_count));
+        append(capabilities.queue_families.data(), capabilities.queue_families.size() * sizeof(vk::QueueFamilyProperties));
+        append(&capabilities.memory, sizeof(capabilities.memory));
+        return result;
+    }
+
+    bool _deserialize_device_capabilities(std::span<const std::byte> bytes, PhysicalDeviceCapabilities& capabilities) {
+        auto read = [&bytes](void* data, std::size_t size) {
+            if (bytes.size() < size) return false;
+            std::memcpy(data, bytes.data(), size);
+            bytes = bytes.subspan(size);
+            return true;
+        };
+        uint32_t extension_count;
+        if (!read(&extension_count, sizeof(extension_count))) return false;
+        capabilities.extensions.clear();
+        for (uint32_t i = 0; i < extension_count; i++) {
+            uint32_t length;
+            if (!read(&length, sizeof(length)) || bytes.size() < length) return false;
+            capabilities.extensions.push_back(_intern_extension_name({reinterpret_cast<const char*>(bytes.data()), length}));
+            bytes = bytes.subspan(length);
+        }
+        uint32_t queue_family_count;
+        if (!read(&queue_family_count, sizeof(queue_family_count))) return false;
+        if (bytes.size() < static_cast<std::size_t>(queue_family_count) * sizeof(vk::QueueFamilyProperties)) return false;
+        capabilities.queue_families.resize(queue_family_count);
+        read(capabilities.queue_families.data(), queue_family_count * sizeof(vk::QueueFamilyProperties));
+        return read(&capabilities.memory, sizeof(capabilities.memory)) && bytes.empty() && std::ranges::is_sorted(capabilities.extensions);
+    }
+
+    // expects device_capabilities_mutex to be held
+    const PhysicalDeviceCapabilities& _query_device_capabilities(const vk::raii::PhysicalDevice& physical_device, utils::DiskCache* cache) {
+        auto handle = static_cast<VkPhysicalDevice>(*physical_device);
+        if (auto it = device_capabilities.find(handle); it != device_capabilities.end()) return it->second;
+
+        PhysicalDeviceCapabilities capabilities;
+        capabilities.properties = physical_device.getProperties();
+        std::vector<std::byte> key;
+        if (cache) {
+            key = _device_capabilities_cache_key(capabilities.properties);
+            auto cached = cache->load(key);
+            if (cached && _deserialize_device_capabilities(*cached, capabilities)) {
+                return device_capabilities.emplace(handle, std::move(capabilities)).first->second;
+            }
+        }
+
+        auto extension_properties_s = physical_device.enumerateDeviceExtensionProperties();
+        capabilities.extensions.reserve(extension_properties_s.size());
+        for (auto& extension_properties: extension_properties_s) {
+            capabilities.extensions.push_back(_intern_extension_name(extension_properties.extensionName.data()));
+        }
+        std::ranges::sort(capabilities.extensions);
+        capabilities.queue_families = physical_device.getQueueFamilyProperties();
+        capabilities.memory = physical_device.getMemoryProperties();
+        if (cache) cache->store(key, _serialize_device_capabilities(capabilities));
+        return device_capabilities.emplace(handle, std::move(capabilities)).first->second;
+    }
+
+    std::optional<utils::DiskCache> _open_device_capabilities_cache() {
+        if (!device_capabilities_cache_directory) return std::nullopt;
+        try {
+            return std::optional<utils::DiskCache>{std::in_place, *device_capabilities_cache_directory, 1024 * 1024};
+        } catch (const std::filesystem::filesystem_error& e) {
+            logger->warn("cannot use device capabilities cache {}: {}", device_capabilities_cache_directory->string(), e.what());
+            return std::nullopt;
+        }
+    }
+}
+
+namespace tiara::core {
+    /**
+     *  @brief query the capabilities of every physical device of the instance, done by Tiara::init
+     */
+    void snapshot_device_capabilities() {
+        auto cache = detail::_open_device_capabilities_cache();
+        std::scoped_lock lock{detail::device_capabilities_mutex};
+        for (auto& physical_device: vk::raii::PhysicalDevices{detail::ctx.value().vk_instance}) {
+            detail::_query_device_capabilities(physical_device, cache ? &*cache : nullptr);
+        }
+    }
+
+    /**
+     *  @brief capabilities of physical_device from the snapshot, queried now if it was not part of it
+     */
+    const PhysicalDeviceCapabilities& device_capabilities(const vk::raii::PhysicalDevice& physical_device) {
+        std::scoped_lock lock{detail::device_capabilities_mutex};
+        return detail::_query_device_capabilities(physical_device, nullptr);
+    }
+
     template <typename... Exts>
     struct Tiara: public extension::Extension<Tiara<Exts...>> {
         virtual void init() final {
             detail::logger->info("initializing tiara");
+            detail::startup_report.restart();
+            auto init_phase = std::optional{detail::startup_report.time("tiara init")};
             step_or_rollback(
+                "glfw init",
                 [](){
                     detail::logger->debug("initializing glfw");
                     if (!glfwInit()) throw exceptions::TiaraGLFWInitError::get_error();
@@ -116,23 +293,28 @@ namespace tiara::core {
                 }
             );
             step_or_rollback(
+                "vulkan instance",
                 [](){
                     uint32_t extensions_count;
                     auto extensions = glfwGetRequiredInstanceExtensions(&extensions_count);
 
                     if (extensions == NULL) throw exceptions::TiaraGLFWInitError::get_error();
 
-                    detail::logger->debug("available vulkan instance layers:");
-                    for (auto& layer_property: vk::enumerateInstanceLayerProperties()) {
-                        detail::logger->debug("{}: {}.{}.{}", layer_property.layerName, VK_VERSION_MAJOR(layer_property.specVersion), VK_VERSION_MINOR(layer_property.specVersion), VK_VERSION_PATCH(layer_property.specVersion));
+                    {
+                        auto enumeration_phase = detail::startup_report.time("vulkan layer and extension enumeration");
+                        detail::logger->debug("available vulkan instance layers:");
+                        for (auto& layer_property: vk::enumerateInstanceLayerProperties()) {
+                            detail::logger->debug("{}: {}.{}.{}", layer_property.layerName, VK_VERSION_MAJOR(layer_property.specVersion), VK_VERSION_MINOR(layer_property.specVersion), VK_VERSION_PATCH(layer_property.specVersion));
+                        }
+
+                        detail::logger->debug("available vulkan instance extension:");
+                        for (auto& extension_property: vk::enumerateInstanceExtensionProperties()) {
+                            detail::logger->debug("{}: {}", extension_property.extensionName, extension_property.specVersion);
+                        }
                     }
 
-                    detail::logger->debug("available vulkan instance extension:");
-                    for (auto& extension_property: vk::enumerateInstanceExtensionProperties()) {
-                        detail::logger->debug("{}: {}", extension_property.extensionName, extension_property.specVersion);
-                    }
-                    
                     detail::logger->debug("creating vulkan instance:");
+                    auto creation_phase = detail::startup_report.time("vulkan instance creation");
 
                     std::vector<const char*> transformed_layers;
                     if (!vulkan_instance_layers.empty()) {
@@ -197,21 +379,42 @@ namespace tiara::core {
                 }
             );
             step_or_rollback(
+                "physical device capabilities",
+                [](){
+                    detail::logger->debug("querying physical device capabilities");
+                    snapshot_device_capabilities();
+                    detail::logger->debug("queried physical device capabilities");
+                },
+                [](){
+                    // handles are only unique within an instance
+                    std::scoped_lock lock{detail::device_capabilities_mutex};
+                    detail::device_capabilities.clear();
+                }
+            );
+            step_or_rollback(
+                "tiara extensions",
                 [](){
                     detail::logger->info("initializing tiara extensions");
                     auto& exts_ref = detail::ctx.value().tiara_exts;
                     exts_ref.reserve(sizeof...(Exts));
-                    (exts_ref.emplace_back(Exts::init_ext()),...);
+                    (_register_lazy_ext<Exts>(),...);
+                    try {
+                        for (std::size_t level = 0; level < _init_plan.level_count; level++) _init_level(level);
+                    } catch(...) {
+                        _deinit_exts();
+                        throw;
+                    }
                     detail::logger->info("initialized tiara extensions");
                 },
                 [](){
                     detail::logger->info("deinitializing tiara extensions");
-                    auto& exts_ref = detail::ctx.value().tiara_exts;
-                    while (!exts_ref.empty()) exts_ref.pop_back();
+                    _deinit_exts();
                     detail::logger->info("deinitialized tiara extensions");
                 }
             );
+            init_phase.reset();
             detail::logger->info("initialized tiara");
+            if (log_startup_report_after_init) log_startup_report(*detail::logger, detail::startup_report);
         }
         virtual void deinit() final {
             detail::logger->info("deinitializing tiara");
@@ -222,10 +425,166 @@ namespace tiara::core {
             return static_cast<bool>(detail::ctx);
         }
         private:
+        static constexpr std::size_t _ext_count = sizeof...(Exts);
+
+        template <typename Ext>
+        static constexpr std::size_t _index_of = [](){
+            std::array<bool, _ext_count> same{std::is_same_v<Ext, Exts>...};
+            return static_cast<std::size_t>(std::ranges::find(same, true) - same.begin());
+        }();
+
+        template <typename Ext>
+        static constexpr std::array<bool, _ext_count> _direct_dependencies_of() {
+            return []<typename... Deps>(std::type_identity<std::tuple<Deps...>>) {
+                static_assert(((_index_of<Deps> < _ext_count) && ...), "every dependency of an extension has to be part of Tiara<Exts...>");
+                std::array<bool, _ext_count> result{};
+                ((result[_index_of<Deps>] = true),...);
+                return result;
+            }(std::type_identity<extension::dependencies_t<Ext>>{});
+        }
+
+        struct _InitPlan {
+            // extensions initialized by init, the non-lazy ones and everything they depend on
+            std::array<bool, _ext_count> eager{};
+            // longest chain of dependencies below each eager extension, extensions of a level only depend on lower ones
+            std::array<std::size_t, _ext_count> level{};
+            std::size_t level_count = 0;
+            bool acyclic = true;
+        };
+
+        static constexpr _InitPlan _init_plan = [](){
+            std::array<std::array<bool, _ext_count>, _ext_count> depends{_direct_dependencies_of<Exts>()...};
+            _InitPlan plan{.eager = {!extension::is_lazy_v<Exts>...}};
+            for (bool changed = true; changed && plan.acyclic;) {
+                changed = false;
+                for (std::size_t i = 0; i < _ext_count; i++) {
+                    for (std::size_t j = 0; j < _ext_count; j++) {
+                        if (!depends[i][j]) continue;
+                        if (plan.eager[i] && !plan.eager[j]) {
+                            plan.eager[j] = true;
+                            changed = true;
+                        }
+                        if (plan.level[i] < plan.level[j] + 1) {
+                            plan.level[i] = plan.level[j] + 1;
+                            changed = true;
+                            // no chain without a cycle is longer than the pack
+                            if (plan.level[i] >= _ext_count) plan.acyclic = false;
+                        }
+                    }
+                }
+            }
+            for (std::size_t i = 0; i < _ext_count; i++) {
+                if (plan.eager[i]) plan.level_count = std::max(plan.level_count, plan.level[i] + 1);
+            }
+            return plan;
+        }();
+        static_assert(_init_plan.acyclic, "dependencies of the extensions of Tiara<Exts...> form a cycle");
+
+        template <typename F>
+        static void _for_each_ext(F&& f) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                (f.template operator()<I, Exts>(),...);
+            }(std::index_sequence_for<Exts...>{});
+        }
+
+        /**
+         *  @brief initialize the eager extensions of a level, the concurrent ones on threads of their own if there is more than one
+         */
+        static void _init_level(std::size_t level) {
+            std::size_t level_size = 0;
+            for (std::size_t i = 0; i < _ext_count; i++) level_size += _init_plan.eager[i] && _init_plan.level[i] == level;
+
+            std::array<std::optional<extension::detail::ExtensionInitHandle>, _ext_count> handles;
+            // each written only by the thread initializing its extension, read once every thread is joined
+            std::array<std::exception_ptr, _ext_count> errors;
+            // what this thread may look at while the others are still going
+            std::atomic<bool> failed{false};
+            std::vector<std::thread> threads;
+            _for_each_ext(
+                [&]<std::size_t I, typename Ext>() {
+                    if (!_init_plan.eager[I] || _init_plan.level[I] != level) return;
+                    auto init = [&handles, &errors, &failed]() {
+                        try {
+                            handles[I] = _timed_init_ext<Ext>();
+                        } catch(...) {
+                            errors[I] = std::current_exception();
+                            failed.store(true, std::memory_order_relaxed);
+                        }
+                    };
+                    if (extension::is_concurrent_init_v<Ext> && level_size > 1) threads.emplace_back(init);
+                }
+            );
+            // the rest runs on this thread while the concurrent ones are going
+            _for_each_ext(
+                [&]<std::size_t I, typename Ext>() {
+                    if (!_init_plan.eager[I] || _init_plan.level[I] != level) return;
+                    if (extension::is_concurrent_init_v<Ext> && level_size > 1) return;
+                    if (failed.load(std::memory_order_relaxed)) return;
+                    try {
+                        handles[I] = _timed_init_ext<Ext>();
+                    } catch(...) {
+                        errors[I] = std::current_exception();
+                        failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+            );
+            for (auto& thread: threads) thread.join();
+
+            // appended even if another extension of the level failed, so the caller deinitializes them
+            auto& exts_ref = detail::ctx.value().tiara_exts;
+            for (auto& handle: handles) {
+                if (handle) exts_ref.push_back(std::move(handle));
+            }
+            for (auto& error: errors) {
+                if (error) std::rethrow_exception(error);
+            }
+            _for_each_ext(
+                [&]<std::size_t I, typename Ext>() {
+                    if (_init_plan.eager[I] && _init_plan.level[I] == level) extension::detail::lazy_extension_state<Ext>.ready.store(true, std::memory_order_release);
+                }
+            );
+        }
+
+        template <typename Ext>
+        static void _register_lazy_ext() {
+            if (_init_plan.eager[_index_of<Ext>]) return;
+            std::scoped_lock lock{extension::detail::lazy_extension_mutex};
+            extension::detail::lazy_extension_state<Ext>.init = [](){
+                []<typename... Deps>(std::type_identity<std::tuple<Deps...>>) {
+                    (extension::require<Deps>(),...);
+                }(std::type_identity<extension::dependencies_t<Ext>>{});
+                // after its dependencies, so it is deinitialized before them
+                auto handle = _timed_init_ext<Ext>();
+                if (handle) detail::ctx.value().tiara_exts.push_back(std::move(handle));
+            };
+        }
+
+        /**
+         *  @brief deinitialize every extension in reverse order of initialization
+         */
+        static void _deinit_exts() {
+            {
+                std::scoped_lock lock{extension::detail::lazy_extension_mutex};
+                ((extension::detail::lazy_extension_state<Exts>.init = nullptr),...);
+                ((extension::detail::lazy_extension_state<Exts>.ready.store(false, std::memory_order_release)),...);
+            }
+            auto& exts_ref = detail::ctx.value().tiara_exts;
+            while (!exts_ref.empty()) exts_ref.pop_back();
+        }
+
+        template <typename Ext>
+        static std::optional<extension::detail::ExtensionInitHandle> _timed_init_ext() {
+            auto phase = detail::startup_report.time("extension " + extension::extension_name<Ext>());
+            return Ext::init_ext();
+        }
+
         template <utils::InvocableR<void> FInit, utils::InvocableR<void> FDeinit>
-        static void step_or_rollback(FInit finit, FDeinit fdeinit) {
+        static void step_or_rollback(const char* name, FInit finit, FDeinit fdeinit) {
             try {
-                finit();
+                {
+                    auto phase = detail::startup_report.time(name);
+                    finit();
+                }
                 deinit_func.emplace_back(fdeinit);
             }  catch(...) {
                 rollback();
@@ -346,7 +705,7 @@ namespace tiara::core {
             std::make_move_iterator(physical_devices.end()),
             std::back_inserter(physical_device_pairs),
             [](vk::raii::PhysicalDevice&& physical_device) -> DevicePropertiesPair {
-                auto properties = physical_device.getProperties();
+                auto properties = device_capabilities(physical_device).properties;
                 return {std::move(physical_device), properties};
             }
         );
@@ -393,10 +752,11 @@ namespace tiara::core {
         QueueFamilyFilterFunc&& queue_filter_func,
         std::shared_ptr<spdlog::logger> logger = nullptr
     ) {
-        auto queue_family_properties = physical_device.getQueueFamilyProperties();
+        const auto& capabilities = device_capabilities(physical_device);
+        const auto& queue_family_properties = capabilities.queue_families;
 
         if (logger && logger->level() <= spdlog::level::debug) {
-            logger->debug("queue families for {}:", physical_device.getProperties().deviceName);
+            logger->debug("queue families for {}:", capabilities.properties.deviceName);
             for (uint32_t i = 0; auto& queue_family_property: queue_family_properties) {
                 logger->debug(
                     "{}: flags: {}, timestamp bits: {}, minimum image transfer granularity: ({}, {}, {}) x {}",
@@ -414,12 +774,12 @@ namespace tiara::core {
 
         auto filtered_family_indices = std::views::iota(uint32_t{0}, static_cast<uint32_t>(queue_family_properties.size())) |
             std::ranges::views::transform(
-                [&queue_family_properties](uint32_t i) -> std::pair<uint32_t, std::reference_wrapper<vk::QueueFamilyProperties>> {
+                [&queue_family_properties](uint32_t i) -> std::pair<uint32_t, std::reference_wrapper<const vk::QueueFamilyProperties>> {
                     return {i, queue_family_properties[i]};
                 }
             ) |
             std::ranges::views::filter(
-                [&queue_filter_func](std::pair<uint32_t, std::reference_wrapper<vk::QueueFamilyProperties>> indexed_queue_family_property) {
+                [&queue_filter_func](std::pair<uint32_t, std::reference_wrapper<const vk::QueueFamilyProperties>> indexed_queue_family_property) {
                     return queue_filter_func(indexed_queue_family_property.first, indexed_queue_family_property.second.get());
                 }
             ) |
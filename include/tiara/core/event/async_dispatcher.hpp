@@ -0,0 +1,422 @@
+#ifndef TIARA_CORE_EVENT_ASYNC_DISPATCHER
+#define TIARA_CORE_EVENT_ASYNC_DISPATCHER
+
+#include "tiara/core/event/dispatcher.hpp"
+#include "tiara/core/event/reducers.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+namespace tiara::core::event {
+    /**
+     *  @brief how a dispatch reduces the results once some handlers missed its deadline
+     */
+    enum class PartialResultPolicy {
+        reduce_finished,   // reduce the results of handlers that finished in time, skipping the late ones
+        reduce_until_late, // reduce in subscription order, stopping at the first late handler
+        fail,              // throw DispatchDeadlineExceeded if any handler is late
+    };
+
+    /**
+     *  @brief time budget of a single dispatch, counted from the start of the dispatch
+     */
+    struct DispatchDeadline {
+        std::chrono::steady_clock::duration budget;
+        PartialResultPolicy policy = PartialResultPolicy::reduce_finished;
+    };
+}
+
+namespace tiara::core::event::exceptions {
+    struct DispatchDeadlineExceeded: public std::runtime_error {
+        DispatchDeadlineExceeded(std::size_t late_handlers):
+            std::runtime_error(std::to_string(late_handlers) + " handlers missed the dispatch deadline"),
+            late_handlers{late_handlers}
+        {}
+
+        std::size_t late_handlers;
+    };
+}
+
+namespace tiara::core::event::detail {
+    template <typename CompletionHandler>
+    struct AsyncHandlerGroupState {
+        AsyncHandlerGroupState(CompletionHandler&& completion_handler, std::size_t count):
+            completion_handler{std::move(completion_handler)},
+            remaining{count}
+        {}
+
+        void complete_one() {
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                // resume the awaiting coroutine on its own executor rather than on the thread of the last handler
+                boost::asio::post(std::move(completion_handler));
+            }
+        }
+
+        CompletionHandler completion_handler;
+        std::atomic<std::size_t> remaining;
+    };
+
+    /**
+     *  @brief start every handler on executor at once and wait for all of them to finish
+     *
+     *  results must hold an empty slot per entry of handlers.handlers() and are stored in handler order, slots of handlers
+     *  unsubscribed before they were started stay empty. the first exception thrown by any handler is rethrown after all have
+     *  finished. synchronous handlers are called on the calling thread while the others are being spawned.
+     */
+    template <std::derived_from<Event> Ev, typename Executor>
+    boost::asio::awaitable<void, Executor> _handle_all(
+        Executor executor,
+        HandlerList<Ev, AsyncHandler<Ev, Executor>*>& handlers,
+        const Ev& event,
+        std::vector<std::optional<typename Ev::RetType>>& results
+    ) {
+        if (handlers.empty()) co_return;
+
+        std::atomic<bool> failed{false};
+        std::exception_ptr exception;
+        co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<Executor>&, void()>(
+            [&executor, &handlers, &event, &results, &failed, &exception](auto completion_handler) {
+                using State = AsyncHandlerGroupState<decltype(completion_handler)>;
+                // one extra count held while spawning, on a multithreaded executor every handler may finish
+                // and resume this coroutine, destroying the captured locals, before the loop returns otherwise
+                std::size_t count = results.size();
+                auto state = std::make_shared<State>(std::move(completion_handler), count + 1);
+                std::size_t started = 0;
+                handlers.for_each([&](AsyncHandler<Ev, Executor>& handler) {
+                    std::size_t i = started++;
+                    if (Handler<Ev>* sync_handler = handler.sync_handler()) {
+                        // nothing to wait for, call it in place instead of spawning a coroutine
+                        try {
+                            results[i].emplace(sync_handler->handle(event, sync_tag));
+                        }
+                        catch (...) {
+                            if (!failed.exchange(true, std::memory_order_relaxed)) exception = std::current_exception();
+                        }
+                        state->complete_one();
+                        return true;
+                    }
+                    boost::asio::co_spawn(
+                        executor,
+                        handler.handle(event),
+                        [state, &results, &failed, &exception, i](std::exception_ptr e, typename Ev::RetType result) {
+                            if (!e) results[i].emplace(std::move(result));
+                            else if (!failed.exchange(true, std::memory_order_relaxed)) exception = e;
+                            state->complete_one();
+                        }
+                    );
+                    return true;
+                });
+                // counts of handlers unsubscribed before they were started, then the one held while spawning
+                for (; started < count; started++) state->complete_one();
+                state->complete_one();
+            },
+            boost::asio::use_awaitable_t<Executor>{}
+        );
+        if (exception) std::rethrow_exception(exception);
+    }
+
+    /**
+     *  @brief results of a group of handlers racing a deadline, owned jointly by the dispatch and the handlers outliving it
+     */
+    template <typename RetType>
+    struct DeadlineHandlerGroup {
+        DeadlineHandlerGroup(std::size_t count): results(count), finished(count, false) {}
+
+        std::mutex mutex;
+        bool completed = false;
+        // requested once the deadline passed, handed to every handler
+        std::stop_source stop;
+        // handlers actually started, the others were unsubscribed before their turn
+        std::size_t started = 0;
+        std::vector<std::optional<RetType>> results;
+        std::vector<bool> finished;
+        std::exception_ptr exception;
+    };
+
+    template <typename CompletionHandler, typename RetType, typename Executor>
+    struct DeadlineHandlerGroupState {
+        using Timer = boost::asio::basic_waitable_timer<std::chrono::steady_clock, boost::asio::wait_traits<std::chrono::steady_clock>, Executor>;
+
+        DeadlineHandlerGroupState(
+            CompletionHandler&& completion_handler,
+            std::shared_ptr<DeadlineHandlerGroup<RetType>> group,
+            std::size_t count,
+            const Executor& executor
+        ):
+            completion_handler{std::move(completion_handler)},
+            group{std::move(group)},
+            remaining{count},
+            timer{executor}
+        {}
+
+        void complete_one(std::size_t i, std::exception_ptr e, std::optional<RetType> result) {
+            std::scoped_lock lock{group->mutex};
+            // the dispatch already returned without this handler
+            if (group->completed) return;
+            group->finished[i] = true;
+            if (!e) group->results[i] = std::move(result);
+            else if (!group->exception) group->exception = e;
+            _release();
+        }
+
+        void finish_spawning(std::size_t started) {
+            std::scoped_lock lock{group->mutex};
+            group->started = started;
+            if (group->completed) return;
+            remaining -= group->finished.size() - started;
+            _release();
+        }
+
+        static void expire(std::shared_ptr<DeadlineHandlerGroupState> state) {
+            std::scoped_lock lock{state->group->mutex};
+            if (state->group->completed) return;
+            state->group->stop.request_stop();
+            state->_complete();
+        }
+
+        CompletionHandler completion_handler;
+        std::shared_ptr<DeadlineHandlerGroup<RetType>> group;
+        std::size_t remaining;
+        Timer timer;
+
+        private:
+        void _release() {
+            if (--remaining == 0) {
+                timer.cancel();
+                _complete();
+            }
+        }
+
+        void _complete() {
+            group->completed = true;
+            boost::asio::post(std::move(completion_handler));
+        }
+    };
+
+    /**
+     *  @brief start every handler on executor at once and wait until all of them finished or budget ran out
+     *
+     *  late handlers are asked to stop through the stop token they were given and keep running in the background until
+     *  they do, with their results dropped. there is a slot per started handler, those of late handlers are empty, the first exception
+     *  thrown in time is rethrown.
+     */
+    template <std::derived_from<Event> Ev, typename Executor>
+    boost::asio::awaitable<std::vector<std::optional<typename Ev::RetType>>, Executor> _handle_all_until(
+        Executor executor,
+        HandlerList<Ev, AsyncHandler<Ev, Executor>*>& handlers,
+        const Ev& event,
+        std::chrono::steady_clock::duration budget
+    ) {
+        using RetType = typename Ev::RetType;
+        if (handlers.empty()) co_return std::vector<std::optional<RetType>>{};
+
+        // late handlers hold the group, the event they were given is copied into it for the same reason
+        auto group = std::make_shared<DeadlineHandlerGroup<RetType>>(handlers.handlers().size());
+        auto owned_event = std::make_shared<const Ev>(event);
+        co_await boost::asio::async_initiate<const boost::asio::use_awaitable_t<Executor>&, void()>(
+            [&executor, &handlers, &owned_event, &group, budget](auto completion_handler) {
+                using State = DeadlineHandlerGroupState<decltype(completion_handler), RetType, Executor>;
+                std::size_t count = group->results.size();
+                auto state = std::make_shared<State>(std::move(completion_handler), group, count + 1, executor);
+                state->timer.expires_after(budget);
+                std::size_t started = 0;
+                handlers.for_each([&](AsyncHandler<Ev, Executor>& handler) {
+                    std::size_t i = started++;
+                    if (Handler<Ev>* sync_handler = handler.sync_handler()) {
+                        std::exception_ptr exception;
+                        std::optional<RetType> result;
+                        try {
+                            result.emplace(sync_handler->handle(*owned_event, sync_tag));
+                        }
+                        catch (...) {
+                            exception = std::current_exception();
+                        }
+                        state->complete_one(i, exception, std::move(result));
+                        return true;
+                    }
+                    auto completion = [state, owned_event, i](std::exception_ptr e, RetType result) {
+                        state->complete_one(i, e, e ? std::nullopt : std::optional<RetType>{std::move(result)});
+                    };
+                    boost::asio::co_spawn(executor, handler.handle(*owned_event, group->stop.get_token()), std::move(completion));
+                    return true;
+                });
+                // armed only once every handler is spawned so expiring never races the spawning
+                state->timer.async_wait([state](const boost::system::error_code& error) {
+                    if (!error) State::expire(state);
+                });
+                state->finish_spawning(started);
+            },
+            boost::asio::use_awaitable_t<Executor>{}
+        );
+        std::scoped_lock lock{group->mutex};
+        if (group->exception) std::rethrow_exception(group->exception);
+        group->results.resize(group->started);
+        co_return std::move(group->results);
+    }
+
+    template <typename DefaultAsyncDispatcher, std::derived_from<Event> Ev, typename Executor>
+    struct DefaultAsyncDispatcherBase: public AsyncDispatcher<Ev, Executor> {
+        public:
+        void start_dispatch(AsyncHandler<Ev, Executor>& h) override {
+            _handlers.subscribe(h);
+            if (!h.sync_handler()) _async_handler_count++;
+        }
+        void stop_dispatch(AsyncHandler<Ev, Executor>& h) override {
+            auto size_before = _handlers.size();
+            _handlers.unsubscribe(h);
+            if (!h.sync_handler()) _async_handler_count -= size_before - _handlers.size();
+        }
+
+        protected:
+        template <typename InitType> requires (!ReducerType<InitType, typename Ev::RetType>)
+        boost::asio::awaitable<InitType, Executor> dispatch(Ev event, InitType init) {
+            co_return co_await dispatch(std::move(event), reducers::fold<InitType, std::plus<>>{std::move(init), std::plus<>{}});
+        }
+
+        template <typename InitType> requires (!ReducerType<InitType, typename Ev::RetType>)
+        boost::asio::awaitable<InitType, Executor> dispatch(Ev event, InitType init, DispatchDeadline deadline) {
+            co_return co_await dispatch(std::move(event), reducers::fold<InitType, std::plus<>>{std::move(init), std::plus<>{}}, deadline);
+        }
+
+        template <typename InitType, std::invocable<const InitType&, const typename Ev::RetType&> Op>
+        boost::asio::awaitable<InitType, Executor> dispatch(Ev event, InitType init, Op op) {
+            co_return co_await dispatch(std::move(event), reducers::fold<InitType, Op>{std::move(init), std::move(op)});
+        }
+
+        /**
+         *  @brief run every handler concurrently on the dispatcher executor and reduce their results in subscription order
+         *
+         *  every handler runs to completion, reducer only decides which results contribute to the returned value.
+         *  when every handler is synchronous they are called in place without suspending or allocating.
+         */
+        template <ReducerType<typename Ev::RetType> Reducer>
+        boost::asio::awaitable<typename Reducer::ResultType, Executor> dispatch(Ev event, Reducer reducer) {
+            if (_async_handler_count == 0) co_return _dispatch_sync(event, reducer);
+
+            // taken from the buffer of the thread starting the dispatch, returned to the one finishing it
+            auto results = std::move(_results_buffer);
+            results.assign(_handlers.handlers().size(), std::nullopt);
+            co_await _handle_all<Ev, Executor>(
+                static_cast<DefaultAsyncDispatcher*>(this)->_executor,
+                _handlers,
+                event,
+                results
+            );
+            typename Reducer::ResultType result = reducer.init();
+            for (auto& handler_result: results) {
+                // unsubscribed before its turn
+                if (!handler_result) continue;
+                if (!reducer.reduce(result, *handler_result)) break;
+            }
+            results.clear();
+            _results_buffer = std::move(results);
+            co_return result;
+        }
+
+        /**
+         *  @brief like dispatch, but stop waiting for handlers once deadline.budget ran out and reduce what finished
+         *
+         *  stop is requested on the std::stop_token passed to handle of late handlers, their results are dropped.
+         *  synchronous handlers are called in place and cannot be interrupted, their time counts against the budget.
+         */
+        template <ReducerType<typename Ev::RetType> Reducer>
+        boost::asio::awaitable<typename Reducer::ResultType, Executor> dispatch(Ev event, Reducer reducer, DispatchDeadline deadline) {
+            auto results = co_await _handle_all_until<Ev, Executor>(
+                static_cast<DefaultAsyncDispatcher*>(this)->_executor,
+                _handlers,
+                event,
+                deadline.budget
+            );
+            std::size_t late_handlers = static_cast<std::size_t>(std::ranges::count_if(results, [](const auto& r) { return !r.has_value(); }));
+            if (late_handlers > 0 && deadline.policy == PartialResultPolicy::fail) {
+                throw exceptions::DispatchDeadlineExceeded{late_handlers};
+            }
+            typename Reducer::ResultType result = reducer.init();
+            for (auto& handler_result: results) {
+                if (!handler_result) {
+                    if (deadline.policy == PartialResultPolicy::reduce_until_late) break;
+                    continue;
+                }
+                if (!reducer.reduce(result, *handler_result)) break;
+            }
+            co_return result;
+        }
+
+        std::span<AsyncHandler<Ev, Executor>* const> handlers() const {
+            return _handlers.handlers();
+        }
+
+        private:
+        template <typename Reducer>
+        typename Reducer::ResultType _dispatch_sync(const Ev& event, Reducer& reducer) {
+            typename Reducer::ResultType result = reducer.init();
+            bool reducing = true;
+            std::exception_ptr exception;
+            // every handler is called even once reducer is done, as on the async path
+            _handlers.for_each([&event, &reducer, &result, &reducing, &exception](AsyncHandler<Ev, Executor>& handler) {
+                try {
+                    auto handler_result = handler.sync_handler()->handle(event, sync_tag);
+                    if (reducing) reducing = reducer.reduce(result, handler_result);
+                }
+                catch (...) {
+                    if (!exception) exception = std::current_exception();
+                }
+                return true;
+            });
+            if (exception) std::rethrow_exception(exception);
+            return result;
+        }
+
+        HandlerList<Ev, AsyncHandler<Ev, Executor>*> _handlers;
+        std::size_t _async_handler_count = 0;
+
+        // reused between dispatches so steady state dispatching does not allocate it,
+        // a nested or interleaved dispatch finds it taken and allocates its own
+        static inline thread_local std::vector<std::optional<typename Ev::RetType>> _results_buffer;
+    };
+}
+
+namespace tiara::core::event {
+    /**
+     *  @brief dispatcher fanning events out to every subscribed AsyncHandler in parallel on executor
+     */
+    template <typename Executor, std::derived_from<Event>... Evs>
+    struct DefaultAsyncDispatcher: public detail::DefaultAsyncDispatcherBase<DefaultAsyncDispatcher<Executor, Evs...>, Evs, Executor>... {
+        public:
+        explicit DefaultAsyncDispatcher(Executor executor): _executor{std::move(executor)} {}
+
+        using detail::DefaultAsyncDispatcherBase<DefaultAsyncDispatcher<Executor, Evs...>, Evs, Executor>::start_dispatch...;
+        using detail::DefaultAsyncDispatcherBase<DefaultAsyncDispatcher<Executor, Evs...>, Evs, Executor>::stop_dispatch...;
+
+        const Executor& executor() const noexcept {
+            return _executor;
+        }
+
+        protected:
+        using detail::DefaultAsyncDispatcherBase<DefaultAsyncDispatcher<Executor, Evs...>, Evs, Executor>::dispatch...;
+
+        template <std::derived_from<Event> Ev> requires (std::same_as<Ev, Evs> || ...)
+        std::span<AsyncHandler<Ev, Executor>* const> handlers() const {
+            return detail::DefaultAsyncDispatcherBase<DefaultAsyncDispatcher<Executor, Evs...>, Ev, Executor>::handlers();
+        }
+
+        private:
+        Executor _executor;
+
+        template <typename DefaultAsyncDispatcherT, std::derived_from<Event> Ev, typename ExecutorT>
+        friend struct detail::DefaultAsyncDispatcherBase;
+    };
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef TIARA_CORE_EVENT_COALESCE
+#define TIARA_CORE_EVENT_COALESCE
+
+#include "tiara/core/event/eventtype.hpp"
+
+#include <concepts>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace tiara::core::event {
+    enum class CoalescePolicy {
+        immediate,   // not buffered, dispatch as soon as the event arrives
+        latest_wins, // keep only the most recent event until flushed
+        accumulate,  // keep every event in arrival order until flushed, merged into one if the type has an EventMerger
+    };
+
+    /**
+     *  @brief specialize with `static void merge(Ev& accumulated, const Ev& next)` to have accumulate fold events of Ev into one,
+     *  e.g. summing scroll deltas
+     */
+    template <std::derived_from<Event> Ev>
+    struct EventMerger {};
+
+    template <typename Ev>
+    concept MergeableEvent = requires (Ev& accumulated, const Ev& next) {
+        EventMerger<Ev>::merge(accumulated, next);
+    };
+
+    /**
+     *  @brief buffer collapsing high frequency events of one type until the owner flushes them, typically once per frame
+     */
+    template <std::derived_from<Event> Ev>
+    class CoalescingBuffer {
+        public:
+        CoalescePolicy policy() const noexcept {
+            return _policy;
+        }
+
+        void set_policy(CoalescePolicy policy) noexcept {
+            _policy = policy;
+        }
+
+        /**
+         *  @brief buffer event according to policy, returns false if it should be dispatched immediately instead
+         */
+        bool push(const Ev& event) {
+            switch (_policy) {
+            case CoalescePolicy::latest_wins:
+                _latest.emplace(event);
+                return true;
+            case CoalescePolicy::accumulate:
+                if constexpr (MergeableEvent<Ev>) {
+                    if (!_accumulated.empty()) {
+                        EventMerger<Ev>::merge(_accumulated.back(), event);
+                        return true;
+                    }
+                }
+                _accumulated.push_back(event);
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        bool empty() const noexcept {
+            return !_latest && _accumulated.empty();
+        }
+
+        /**
+         *  @brief pass buffered events to f and clear the buffer, returns the number of events passed
+         *
+         *  events pushed by f are kept for the next flush
+         */
+        template <std::invocable<const Ev&> F>
+        std::size_t flush(F&& f) {
+            std::size_t count = 0;
+            if (!_accumulated.empty()) {
+                // swap so f can push while the flushed events are iterated, both buffers keep their capacity
+                std::swap(_accumulated, _flushing);
+                for (const Ev& event: _flushing) f(event);
+                count += _flushing.size();
+                _flushing.clear();
+            }
+            if (_latest) {
+                Ev event{std::move(*_latest)};
+                _latest.reset();
+                f(event);
+                count++;
+            }
+            return count;
+        }
+
+        /**
+         *  @brief like flush, but pass buffered events to f as spans so they can be delivered in batches
+         */
+        template <std::invocable<std::span<const Ev>> F>
+        std::size_t flush_batch(F&& f) {
+            std::size_t count = 0;
+            if (!_accumulated.empty()) {
+                std::swap(_accumulated, _flushing);
+                f(std::span<const Ev>{_flushing});
+                count += _flushing.size();
+                _flushing.clear();
+            }
+            if (_latest) {
+                Ev event{std::move(*_latest)};
+                _latest.reset();
+                f(std::span<const Ev>{&event, 1});
+                count++;
+            }
+            return count;
+        }
+
+        private:
+        CoalescePolicy _policy = CoalescePolicy::immediate;
+        std::optional<Ev> _latest;
+        std::vector<Ev> _accumulated;
+        std::vector<Ev> _flushing;
+    };
+}
+
+#endif
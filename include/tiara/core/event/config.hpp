@@ -0,0 +1,9 @@
+#ifndef TIARA_CORE_EVENT_CONFIG
+#define TIARA_CORE_EVENT_CONFIG
+
+// record dispatch counts and handler latencies in dispatchers, see tiara/core/event/statistics.hpp
+#ifndef TIARA_ENABLE_EVENT_STATISTICS
+#define TIARA_ENABLE_EVENT_STATISTICS 0
+#endif
+
+#endif
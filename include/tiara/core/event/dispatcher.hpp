@@ -1,11 +1,24 @@
 #ifndef TIARA_CORE_EVENT_DISPATCHER
 #define TIARA_CORE_EVENT_DISPATCHER
 
+#include "tiara/core/event/config.hpp"
 #include "tiara/core/event/handler.hpp"
+#include "tiara/core/event/reducers.hpp"
+#include "tiara/core/utilities/concept_invocable.hpp"
 #include "tiara/core/utilities/predicate_combinators.hpp"
 #include "tiara/core/utilities/remove_erase.hpp"
+#include "tiara/core/utilities/slot_map.hpp"
 
-#include <numeric>
+#if TIARA_ENABLE_EVENT_STATISTICS
+#include "tiara/core/event/statistics.hpp"
+#endif
+
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace tiara::core::event {
     template <typename T, typename Hdlr, typename Ev, typename Executor>
@@ -28,52 +41,318 @@ namespace tiara::core::event {
         virtual void start_dispatch(Handler<Ev>& h) = 0;
         virtual void stop_dispatch(Handler<Ev>& h) = 0;
     };
+
+    /**
+     *  @brief handle to a single subscription of a handler to a dispatcher, stale once unsubscribed
+     */
+    template <std::derived_from<Event> Ev>
+    struct Subscription {
+        utils::SlotMapKey key;
+
+        constexpr auto operator<=>(const Subscription&) const = default;
+    };
 }
 
 namespace tiara::core::event::detail {
+    template <typename Entry>
+    struct HandlerOfEntry {
+        using type = std::remove_pointer_t<decltype(std::declval<Entry&>().handler)>;
+    };
+    template <typename H>
+    struct HandlerOfEntry<H*> {
+        using type = H;
+    };
+
+    /**
+     *  @brief handlers of a single event type, with O(1) subscribe and unsubscribe and contiguous iteration
+     *
+     *  Entry is either the handler pointer itself or a struct holding it as its `handler` member alongside extra data,
+     *  the handler may be a Handler or an AsyncHandler.
+     *  iteration order is subscription order, unsubscribing leaves a tombstone so the remaining handlers keep it.
+     *  tombstones are compacted in one stable pass once the outermost for_each returns, or outside of for_each once
+     *  they outnumber the subscribed handlers.
+     *  subscription changes made while for_each is running, including from inside a handler, are safe:
+     *  handlers subscribed during it are first called on the next for_each, handlers unsubscribed during it
+     *  are not called again.
+     */
+    template <std::derived_from<Event> Ev, typename Entry = Handler<Ev>*>
+    class HandlerList {
+        public:
+        using HandlerT = typename HandlerOfEntry<Entry>::type;
+
+        template <typename... Args>
+        Subscription<Ev> subscribe(HandlerT& h, Args&&... args) {
+            utils::SlotMapKey key;
+            if constexpr (_is_plain) key = _handlers.emplace(std::addressof(h));
+            else key = _handlers.emplace(Entry{std::addressof(h), std::forward<Args>(args)...});
+            _handler_keys.emplace(std::addressof(h), key);
+            return {key};
+        }
+
+        bool unsubscribe(Subscription<Ev> subscription) {
+            auto entry = _handlers.find(subscription.key);
+            if (!entry || !_handler_of(*entry)) return false;
+            auto [begin, end] = _handler_keys.equal_range(_handler_of(*entry));
+            for (auto it = begin; it != end; it++) {
+                if (it->second == subscription.key) {
+                    _handler_keys.erase(it);
+                    break;
+                }
+            }
+            _erase(subscription.key);
+            return true;
+        }
+
+        /**
+         *  @brief unsubscribe every subscription of h
+         */
+        void unsubscribe(HandlerT& h) {
+            auto [begin, end] = _handler_keys.equal_range(std::addressof(h));
+            for (auto it = begin; it != end; it++) _erase(it->second);
+            _handler_keys.erase(begin, end);
+        }
+
+        bool is_subscribed(Subscription<Ev> subscription) const noexcept {
+            return find(subscription) != nullptr;
+        }
+
+        /**
+         *  @brief whether h has any subscription left, h is not accessed and may already be destroyed
+         */
+        bool is_subscribed(const HandlerT* h) const {
+            return _handler_keys.contains(const_cast<HandlerT*>(h));
+        }
+
+        /**
+         *  @brief handler of subscription, or null if it is not subscribed
+         */
+        HandlerT* find(Subscription<Ev> subscription) const noexcept {
+            auto entry = _handlers.find(subscription.key);
+            return entry ? _handler_of(*entry) : nullptr;
+        }
+
+        /**
+         *  @brief call f with each subscribed handler (or entry, if Entry is not a plain pointer) until it returns false
+         */
+        template <typename F>
+        void for_each(F&& f) {
+            DispatchScope scope{*this};
+            // index instead of iterators: subscribing from f may reallocate storage
+            std::size_t count = _handlers.values().size();
+            for (std::size_t i = 0; i < count; i++) {
+                // tombstones have a null handler
+                Entry& entry = _handlers.values()[i];
+                if (!_handler_of(entry)) continue;
+                if constexpr (_is_plain) {
+                    if (!f(*entry)) break;
+                } else {
+                    if (!f(static_cast<const Entry&>(entry))) break;
+                }
+            }
+        }
+
+        /**
+         *  @brief subscribed entries in subscription order, with a null handler in entries unsubscribed but not compacted yet
+         */
+        std::span<const Entry> handlers() const noexcept {
+            return _handlers.values();
+        }
+
+        std::size_t size() const noexcept {
+            return _handlers.size();
+        }
+
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        bool dispatching() const noexcept {
+            return _dispatch_depth > 0;
+        }
+
+        private:
+        static constexpr bool _is_plain = std::is_pointer_v<Entry>;
+
+        static HandlerT*& _handler_of(Entry& entry) noexcept {
+            if constexpr (_is_plain) return entry;
+            else return entry.handler;
+        }
+        static HandlerT* _handler_of(const Entry& entry) noexcept {
+            if constexpr (_is_plain) return entry;
+            else return entry.handler;
+        }
+
+        struct DispatchScope {
+            DispatchScope(HandlerList& list) noexcept: list{list} {
+                list._dispatch_depth++;
+            }
+            ~DispatchScope() {
+                // a pass over the handlers just like the dispatch that is ending
+                if (--list._dispatch_depth == 0 && list._handlers.tombstones() > 0) list._handlers.compact();
+            }
+            HandlerList& list;
+        };
+
+        void _erase(utils::SlotMapKey key) {
+            _handler_of(*_handlers.find(key)) = nullptr;
+            _handlers.erase(key);
+            // amortized O(1), a for_each may be iterating the storage otherwise
+            if (_dispatch_depth == 0 && _handlers.tombstones() > _handlers.size()) _handlers.compact();
+        }
+
+        utils::SlotMap<Entry> _handlers;
+        std::unordered_multimap<HandlerT*, utils::SlotMapKey> _handler_keys;
+        std::size_t _dispatch_depth = 0;
+    };
+
     template <std::derived_from<Event> Ev>
     struct DefaultDispatcherBase: public Dispatcher<Ev> {
         public:
         void start_dispatch(Handler<Ev>& h) override {
-            _handlers.emplace_back(h);
+            _handlers.subscribe(h);
         }
         void stop_dispatch(Handler<Ev>& h) override {
-            utils::remove_erase_if(_handlers, [&h](const auto& ref_wrap) { return ref_wrap.get() == h; });
+            _handlers.unsubscribe(h);
+            #if TIARA_ENABLE_EVENT_STATISTICS
+            _statistics.forget_handler(h);
+            #endif
+        }
+
+        Subscription<Ev> subscribe(Handler<Ev>& h) {
+            return _handlers.subscribe(h);
+        }
+        bool unsubscribe(Subscription<Ev> subscription) {
+            #if TIARA_ENABLE_EVENT_STATISTICS
+            Handler<Ev>* h = _handlers.find(subscription);
+            if (!_handlers.unsubscribe(subscription)) return false;
+            if (!_handlers.is_subscribed(h)) _statistics.forget_handler(*h);
+            return true;
+            #else
+            return _handlers.unsubscribe(subscription);
+            #endif
+        }
+        bool is_subscribed(Subscription<Ev> subscription) const noexcept {
+            return _handlers.is_subscribed(subscription);
         }
 
         protected:
-        template <typename InitType>
+        template <typename InitType> requires (!ReducerType<InitType, typename Ev::RetType>)
         InitType dispatch(const Ev& event, const InitType& init) {
-            _dispatch_event_to_results_vec(event);
-            return std::accumulate(std::ranges::begin(_results), std::ranges::end(_results), init);
+            return dispatch(event, init, std::plus<>{});
         }
 
         template <typename InitType, std::invocable<const InitType&, const typename Ev::RetType&> Op>
         InitType dispatch(const Ev& event, const InitType& init, Op op) {
-            _dispatch_event_to_results_vec(event);
-            return std::accumulate(std::ranges::begin(_results), std::ranges::end(_results), init, op);
+            return dispatch(event, reducers::fold<InitType, Op>{init, std::move(op)});
         }
 
-        const std::vector<std::reference_wrapper<Handler<Ev>>>& handlers() const {
-            return _handlers;
+        /**
+         *  @brief dispatch event to handlers in order, folding each result into reducer as it is returned
+         *  
+         *  no intermediate storage is used and remaining handlers are skipped once reducer returns false
+         */
+        template <ReducerType<typename Ev::RetType> Reducer>
+        typename Reducer::ResultType dispatch(const Ev& event, Reducer reducer) {
+            typename Reducer::ResultType result = reducer.init();
+            #if TIARA_ENABLE_EVENT_STATISTICS
+            _statistics.record_dispatch();
+            _handlers.for_each(
+                [this, &event, &reducer, &result](Handler<Ev>& h) {
+                    return reducer.reduce(
+                        result,
+                        _statistics.record_handler_call(h, [&h, &event]() { return h.handle(event, core::event::sync_tag); })
+                    );
+                }
+            );
+            #else
+            _handlers.for_each(
+                [&event, &reducer, &result](Handler<Ev>& h) {
+                    return reducer.reduce(result, h.handle(event, core::event::sync_tag));
+                }
+            );
+            #endif
+            return result;
         }
 
-        private:
-        std::vector<std::reference_wrapper<Handler<Ev>>> _handlers;
-        std::vector<typename Ev::RetType> _results;
-
-        void _dispatch_event_to_results_vec(const Ev& event) {
-            _results.clear();
-            _results.reserve(_handlers.size());
-            auto [begin, end] = std::ranges::transform(
-                _handlers,
-                std::back_inserter(_results),
-                [&event](Handler<Ev>& h) {
-                    return h.handle(event, core::event::sync_tag);
+        /**
+         *  @brief deliver events to every handler with a single handle_batch call each
+         *
+         *  results are discarded, so a handler consuming an event does not keep it from later handlers.
+         */
+        void dispatch_batch(std::span<const Ev> events) {
+            if (events.empty()) return;
+            #if TIARA_ENABLE_EVENT_STATISTICS
+            _statistics.record_dispatch(events.size());
+            _handlers.for_each(
+                [this, events](Handler<Ev>& h) {
+                    _statistics.record_handler_call(h, [&h, events]() { h.handle_batch(events, core::event::sync_tag); });
+                    return true;
                 }
             );
-            _results.shrink_to_fit();
+            #else
+            _handlers.for_each(
+                [events](Handler<Ev>& h) {
+                    h.handle_batch(events, core::event::sync_tag);
+                    return true;
+                }
+            );
+            #endif
+        }
+
+        /**
+         *  @brief accumulate event to be delivered in a batch by the next flush_deferred
+         */
+        void defer(const Ev& event) {
+            _deferred.push_back(event);
+        }
+
+        /**
+         *  @brief deliver deferred events with dispatch_batch, returns the number of events delivered
+         *
+         *  events deferred by handlers during the flush are kept for the next one, a flush from a handler delivers only those.
+         */
+        std::size_t flush_deferred() {
+            if (_deferred.empty()) return 0;
+            // the batch is taken out so handlers can defer and flush while it is delivered, a nested flush finds the spare
+            // buffer taken and allocates its own
+            std::vector<Ev> batch = std::move(_flushing);
+            batch.clear();
+            std::swap(batch, _deferred);
+            dispatch_batch(batch);
+            std::size_t count = batch.size();
+            batch.clear();
+            _flushing = std::move(batch);
+            return count;
         }
+
+        std::span<Handler<Ev>* const> handlers() const {
+            return _handlers.handlers();
+        }
+
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        public:
+        EventStatistics<Ev>& statistics() noexcept {
+            return _statistics;
+        }
+        const EventStatistics<Ev>& statistics() const noexcept {
+            return _statistics;
+        }
+
+        EventStatisticsSnapshot statistics_snapshot() const {
+            EventStatisticsSnapshot snapshot = _statistics.snapshot();
+            snapshot.subscribed_handlers = _handlers.size();
+            return snapshot;
+        }
+        #endif
+
+        private:
+        HandlerList<Ev> _handlers;
+        std::vector<Ev> _deferred;
+        // spare buffer swapped with _deferred on flush so both keep their capacity
+        std::vector<Ev> _flushing;
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        EventStatistics<Ev> _statistics;
+        #endif
     };
 
     template <typename DelegatingSharedDispatcher, std::derived_from<Event> Ev>
@@ -84,6 +363,19 @@ namespace tiara::core::event::detail {
         void stop_dispatch(Handler<Ev>& h) override {
             static_cast<DelegatingSharedDispatcher*>(this)->_dispatcher->stop_dispatch(h);
         }
+
+        Subscription<Ev> subscribe(Handler<Ev>& h) {
+            return static_cast<DelegatingSharedDispatcher*>(this)->_dispatcher->subscribe(h);
+        }
+        bool unsubscribe(Subscription<Ev> subscription) {
+            return static_cast<DelegatingSharedDispatcher*>(this)->_dispatcher->unsubscribe(subscription);
+        }
+        #if TIARA_ENABLE_EVENT_STATISTICS
+
+        EventStatistics<Ev>& statistics() noexcept {
+            return static_cast<DelegatingSharedDispatcher*>(this)->_dispatcher->template statistics<Ev>();
+        }
+        #endif
     };
 }
 
@@ -93,12 +385,51 @@ namespace tiara::core::event {
         public:
         using detail::DefaultDispatcherBase<Evs>::start_dispatch...;
         using detail::DefaultDispatcherBase<Evs>::stop_dispatch...;
+        using detail::DefaultDispatcherBase<Evs>::subscribe...;
+        using detail::DefaultDispatcherBase<Evs>::unsubscribe...;
+        using detail::DefaultDispatcherBase<Evs>::is_subscribed...;
+
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        template <std::derived_from<Event> Ev> requires (std::same_as<Ev, Evs> || ...)
+        EventStatistics<Ev>& statistics() noexcept {
+            return detail::DefaultDispatcherBase<Ev>::statistics();
+        }
+        template <std::derived_from<Event> Ev> requires (std::same_as<Ev, Evs> || ...)
+        const EventStatistics<Ev>& statistics() const noexcept {
+            return detail::DefaultDispatcherBase<Ev>::statistics();
+        }
+
+        /**
+         *  @brief snapshot statistics of every event type
+         */
+        std::vector<EventStatisticsSnapshot> statistics_snapshot() const {
+            return {detail::DefaultDispatcherBase<Evs>::statistics_snapshot()...};
+        }
+
+        void reset_statistics() noexcept {
+            (detail::DefaultDispatcherBase<Evs>::statistics().reset(), ...);
+        }
+        #endif
 
         protected:
         using detail::DefaultDispatcherBase<Evs>::dispatch...;
+        using detail::DefaultDispatcherBase<Evs>::dispatch_batch...;
+        using detail::DefaultDispatcherBase<Evs>::defer...;
 
         template <std::derived_from<Event> Ev> requires (std::same_as<Ev, Evs> || ...)
-        const std::vector<std::reference_wrapper<Handler<Ev>>>& handlers() const {
+        std::size_t flush_deferred() {
+            return detail::DefaultDispatcherBase<Ev>::flush_deferred();
+        }
+
+        /**
+         *  @brief flush deferred events of every event type, one type after another
+         */
+        std::size_t flush_deferred() {
+            return (detail::DefaultDispatcherBase<Evs>::flush_deferred() + ...);
+        }
+
+        template <std::derived_from<Event> Ev> requires (std::same_as<Ev, Evs> || ...)
+        std::span<Handler<Ev>* const> handlers() const {
             return detail::DefaultDispatcherBase<Ev>::handlers();
         }
     };
@@ -111,6 +442,23 @@ namespace tiara::core::event {
 
         using detail::DelegatingSharedDispatcherBase<DelegatingSharedDispatcher<DelegatedDispatcherType, Evs...>, Evs>::start_dispatch...;
         using detail::DelegatingSharedDispatcherBase<DelegatingSharedDispatcher<DelegatedDispatcherType, Evs...>, Evs>::stop_dispatch...;
+        using detail::DelegatingSharedDispatcherBase<DelegatingSharedDispatcher<DelegatedDispatcherType, Evs...>, Evs>::subscribe...;
+        using detail::DelegatingSharedDispatcherBase<DelegatingSharedDispatcher<DelegatedDispatcherType, Evs...>, Evs>::unsubscribe...;
+
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        template <std::derived_from<Event> Ev> requires (std::same_as<Ev, Evs> || ...)
+        EventStatistics<Ev>& statistics() noexcept {
+            return detail::DelegatingSharedDispatcherBase<DelegatingSharedDispatcher<DelegatedDispatcherType, Evs...>, Ev>::statistics();
+        }
+
+        std::vector<EventStatisticsSnapshot> statistics_snapshot() const {
+            return _dispatcher->statistics_snapshot();
+        }
+
+        void reset_statistics() noexcept {
+            _dispatcher->reset_statistics();
+        }
+        #endif
 
         protected:
         std::shared_ptr<DelegatedDispatcherType>& dispatcher() {
@@ -132,17 +480,17 @@ namespace tiara::core::event {
         template <typename... Args>
         KeepAliveDispatcher(Args&&... args): Dispatch{args...} {}
 
-        void start_dispatch(std::shared_ptr<Hdlr> h) override {
-            _keep_shared_alive.emplace_back(std::move(h));
+        void start_dispatch(std::shared_ptr<Hdlr> h) {
             Dispatch::start_dispatch(*h);
+            _keep_shared_alive.try_emplace(h.get(), std::move(h));
         }
-        void stop_dispatch(std::shared_ptr<Hdlr> h) override {
+        void stop_dispatch(std::shared_ptr<Hdlr> h) {
             Dispatch::stop_dispatch(*h);
-            utils::remove_erase(_keep_shared_alive, h);
+            _keep_shared_alive.erase(h.get());
         }
 
         private:
-        std::vector<std::shared_ptr<Hdlr>> _keep_shared_alive;
+        std::unordered_map<Hdlr*, std::shared_ptr<Hdlr>> _keep_shared_alive;
     } ;
 }
 
@@ -1,9 +1,17 @@
 #ifndef TIARA_CORE_EVENT_EVENT
 #define TIARA_CORE_EVENT_EVENT
 
+#include "tiara/core/event/async_dispatcher.hpp"
+#include "tiara/core/event/coalesce.hpp"
 #include "tiara/core/event/dispatcher.hpp"
 #include "tiara/core/event/eventtype.hpp"
+#include "tiara/core/event/event_bus.hpp"
+#include "tiara/core/event/event_queue.hpp"
 #include "tiara/core/event/handler.hpp"
 #include "tiara/core/event/managed_handler.hpp"
+#include "tiara/core/event/record.hpp"
+#include "tiara/core/event/reducers.hpp"
+#include "tiara/core/event/routed_dispatcher.hpp"
+#include "tiara/core/event/static_dispatcher.hpp"
 
 #endif
@@ -0,0 +1,243 @@
+#ifndef TIARA_CORE_EVENT_EVENT_BUS
+#define TIARA_CORE_EVENT_EVENT_BUS
+
+#include "tiara/core/event/dispatcher.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace tiara::core::event {
+    /**
+     *  @brief compact id of an event type, assigned in registration order
+     */
+    using EventTypeId = std::uint32_t;
+
+    struct EventTypeInfo {
+        std::string name;
+        std::size_t size;
+    };
+
+    /**
+     *  @brief event of a type registered at runtime, carrying its payload as raw bytes
+     */
+    struct DynamicEvent: Event {
+        using RetType = bool;
+        EventTypeId type;
+        std::span<const std::byte> payload;
+    };
+}
+
+namespace tiara::core::event::exceptions {
+    struct EventTypeMismatch: public std::runtime_error {
+        EventTypeMismatch(const std::string& description): std::runtime_error(description) {}
+    };
+}
+
+namespace tiara::core::event::detail {
+    class EventTypeRegistry {
+        public:
+        EventTypeId add(std::string name, std::size_t size) {
+            std::scoped_lock lock{_mutex};
+            _types.push_back(std::make_unique<EventTypeInfo>(EventTypeInfo{std::move(name), size}));
+            return static_cast<EventTypeId>(_types.size() - 1);
+        }
+
+        const EventTypeInfo& info(EventTypeId id) const {
+            std::scoped_lock lock{_mutex};
+            return *_types.at(id);
+        }
+
+        std::size_t size() const {
+            std::scoped_lock lock{_mutex};
+            return _types.size();
+        }
+
+        private:
+        mutable std::mutex _mutex;
+        // infos are handed out by reference while registration may grow the vector
+        std::vector<std::unique_ptr<EventTypeInfo>> _types;
+    };
+
+    inline EventTypeRegistry event_type_registry;
+}
+
+namespace tiara::core::event {
+    /**
+     *  @brief id of Ev, registered on first use
+     */
+    template <std::derived_from<Event> Ev>
+    EventTypeId event_type_id() {
+        static const EventTypeId id = detail::event_type_registry.add(typeid(Ev).name(), sizeof(Ev));
+        return id;
+    }
+
+    /**
+     *  @brief register an event type without a C++ type of its own, its events are dispatched as DynamicEvent
+     */
+    inline EventTypeId register_event_type(std::string name, std::size_t size) {
+        return detail::event_type_registry.add(std::move(name), size);
+    }
+
+    inline const EventTypeInfo& event_type_info(EventTypeId id) {
+        return detail::event_type_registry.info(id);
+    }
+
+    /**
+     *  @brief dispatcher of any number of event types, keeping the handlers of each in a flat table indexed by EventTypeId
+     *
+     *  unlike DefaultDispatcher<Evs...> it is a single non-template class, so event types cost no base class or vtable
+     *  and can be added after construction. handlers are plain Handler<Ev>, runtime registered types use Handler<DynamicEvent>.
+     *  reentrancy guarantees are the ones of HandlerList, per event type.
+     */
+    class EventBus {
+        public:
+        EventBus() = default;
+        EventBus(const EventBus&) = delete;
+        EventBus& operator=(const EventBus&) = delete;
+
+        template <std::derived_from<Event> Ev>
+        void start_dispatch(Handler<Ev>& h) {
+            _list_of<Ev>(event_type_id<Ev>()).subscribe(h);
+        }
+        template <std::derived_from<Event> Ev>
+        void stop_dispatch(Handler<Ev>& h) {
+            if (auto* list = _find_list<Ev>(event_type_id<Ev>())) list->unsubscribe(h);
+        }
+
+        template <std::derived_from<Event> Ev>
+        Subscription<Ev> subscribe(Handler<Ev>& h) {
+            return _list_of<Ev>(event_type_id<Ev>()).subscribe(h);
+        }
+        template <std::derived_from<Event> Ev>
+        bool unsubscribe(Subscription<Ev> subscription) {
+            auto* list = _find_list<Ev>(event_type_id<Ev>());
+            return list && list->unsubscribe(subscription);
+        }
+        template <std::derived_from<Event> Ev>
+        bool is_subscribed(Subscription<Ev> subscription) const {
+            auto* list = _find_list<Ev>(event_type_id<Ev>());
+            return list && list->is_subscribed(subscription);
+        }
+
+        /**
+         *  @brief subscribe h to the runtime registered event type type
+         */
+        Subscription<DynamicEvent> subscribe(EventTypeId type, Handler<DynamicEvent>& h) {
+            return _list_of<DynamicEvent>(type).subscribe(h);
+        }
+        bool unsubscribe(EventTypeId type, Subscription<DynamicEvent> subscription) {
+            auto* list = _find_list<DynamicEvent>(type);
+            return list && list->unsubscribe(subscription);
+        }
+        void unsubscribe(EventTypeId type, Handler<DynamicEvent>& h) {
+            if (auto* list = _find_list<DynamicEvent>(type)) list->unsubscribe(h);
+        }
+
+        template <std::derived_from<Event> Ev>
+        std::size_t handler_count() const {
+            auto* list = _find_list<Ev>(event_type_id<Ev>());
+            return list ? list->size() : 0;
+        }
+        std::size_t handler_count(EventTypeId type) const {
+            auto* list = _find_list<DynamicEvent>(type);
+            return list ? list->size() : 0;
+        }
+
+        protected:
+        template <std::derived_from<Event> Ev, typename InitType> requires (!ReducerType<InitType, typename Ev::RetType>)
+        InitType dispatch(const Ev& event, const InitType& init) {
+            return dispatch(event, init, std::plus<>{});
+        }
+
+        template <std::derived_from<Event> Ev, typename InitType, std::invocable<const InitType&, const typename Ev::RetType&> Op>
+        InitType dispatch(const Ev& event, const InitType& init, Op op) {
+            return dispatch(event, reducers::fold<InitType, Op>{init, std::move(op)});
+        }
+
+        /**
+         *  @brief dispatch event to the handlers of its type in order, like DefaultDispatcher::dispatch
+         *
+         *  DynamicEvent is routed by its type member rather than by its C++ type.
+         */
+        template <std::derived_from<Event> Ev, ReducerType<typename Ev::RetType> Reducer>
+        typename Reducer::ResultType dispatch(const Ev& event, Reducer reducer) {
+            typename Reducer::ResultType result = reducer.init();
+            EventTypeId type;
+            if constexpr (std::same_as<Ev, DynamicEvent>) type = event.type;
+            else type = event_type_id<Ev>();
+            auto* list = _find_list<Ev>(type);
+            if (!list) return result;
+            list->for_each(
+                [&event, &reducer, &result](Handler<Ev>& h) {
+                    return reducer.reduce(result, h.handle(event, core::event::sync_tag));
+                }
+            );
+            return result;
+        }
+
+        private:
+        // handler list of whatever type the id belongs to, type erased without a vtable
+        struct ErasedList {
+            std::unique_ptr<void, void(*)(void*)> list{nullptr, [](void*) {}};
+            // address of _list_tag<Ev> of the Ev the list was created for
+            const void* tag = nullptr;
+        };
+
+        template <std::derived_from<Event> Ev>
+        static constexpr char _list_tag = 0;
+
+        template <std::derived_from<Event> Ev>
+        detail::HandlerList<Ev>& _list_of(EventTypeId type) {
+            if (type >= _lists.size()) {
+                if (type >= detail::event_type_registry.size()) throw exceptions::EventTypeMismatch{"unregistered event type id " + std::to_string(type)};
+                _lists.resize(detail::event_type_registry.size());
+            }
+            ErasedList& entry = _lists[type];
+            if (!entry.list) {
+                entry.list = {new detail::HandlerList<Ev>{}, [](void* p) { delete static_cast<detail::HandlerList<Ev>*>(p); }};
+                entry.tag = &_list_tag<Ev>;
+            }
+            else if (entry.tag != &_list_tag<Ev>) {
+                // e.g. subscribing a Handler<DynamicEvent> to the id of a C++ event type
+                throw exceptions::EventTypeMismatch{"handler does not match event type " + event_type_info(type).name};
+            }
+            return *static_cast<detail::HandlerList<Ev>*>(entry.list.get());
+        }
+
+        template <std::derived_from<Event> Ev>
+        detail::HandlerList<Ev>* _find_list(EventTypeId type) const noexcept {
+            if (type >= _lists.size() || _lists[type].tag != &_list_tag<Ev>) return nullptr;
+            return static_cast<detail::HandlerList<Ev>*>(_lists[type].list.get());
+        }
+
+        std::vector<ErasedList> _lists;
+    };
+
+    /**
+     *  @brief Dispatcher<Ev> subscribing to the Ev handlers of an EventBus, for code written against the virtual interface
+     */
+    template <std::derived_from<Event> Ev>
+    class EventBusDispatcher: public Dispatcher<Ev> {
+        public:
+        explicit EventBusDispatcher(EventBus& bus): _bus{bus} {}
+
+        void start_dispatch(Handler<Ev>& h) override {
+            _bus.start_dispatch(h);
+        }
+        void stop_dispatch(Handler<Ev>& h) override {
+            _bus.stop_dispatch(h);
+        }
+
+        private:
+        EventBus& _bus;
+    };
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef TIARA_CORE_EVENT_EVENT_QUEUE
+#define TIARA_CORE_EVENT_EVENT_QUEUE
+
+#include "tiara/core/event/eventtype.hpp"
+#include "tiara/core/utilities/mpsc_queue.hpp"
+
+#include <concepts>
+#include <variant>
+
+namespace tiara::core::event {
+    static inline std::size_t default_event_queue_capacity = 1024;
+
+    /**
+     *  @brief queue for posting events from any thread, to be dispatched in batches on the thread owning the dispatcher
+     */
+    template <std::derived_from<Event>... Evs>
+    class EventQueue {
+        public:
+        using EventVariant = std::variant<Evs...>;
+
+        EventQueue(): EventQueue{default_event_queue_capacity} {}
+        explicit EventQueue(std::size_t capacity): _queue{capacity} {}
+
+        /**
+         *  @brief post an event, returns false if the queue is full
+         */
+        template <std::derived_from<Event> Ev> requires (std::same_as<Ev, Evs> || ...)
+        bool post(const Ev& event) {
+            return _queue.try_emplace(std::in_place_type<Ev>, event);
+        }
+
+        /**
+         *  @brief pass at most max_count posted events to f in posting order, returns the number of events passed
+         */
+        template <typename F> requires (std::invocable<F&, const Evs&> && ...)
+        std::size_t drain(F&& f, std::size_t max_count) {
+            return _queue.drain(
+                [&f](EventVariant&& event) {
+                    std::visit(f, static_cast<const EventVariant&>(event));
+                },
+                max_count
+            );
+        }
+
+        template <typename F> requires (std::invocable<F&, const Evs&> && ...)
+        std::size_t drain(F&& f) {
+            return drain(std::forward<F>(f), _queue.capacity());
+        }
+
+        std::size_t capacity() const noexcept {
+            return _queue.capacity();
+        }
+
+        private:
+        utils::BoundedMPSCQueue<EventVariant> _queue;
+    };
+}
+
+#endif
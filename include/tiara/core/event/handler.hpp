@@ -8,11 +8,16 @@
 #include <boost/asio.hpp>
 
 #include <memory>
+#include <span>
+#include <stop_token>
 
 namespace tiara::core::event {
     struct sync_tag_t {};
     static constexpr sync_tag_t sync_tag;
 
+    template <std::derived_from<Event> Ev>
+    struct Handler;
+
     template <std::derived_from<Event> Ev, typename Executor = boost::asio::any_io_executor>
     struct AsyncHandler {
         AsyncHandler() = default;
@@ -23,6 +28,24 @@ namespace tiara::core::event {
 
         virtual boost::asio::awaitable<typename Ev::RetType, Executor> handle(const Ev& event) = 0;
 
+        /**
+         *  @brief handle event for a dispatch with a deadline, stop is requested once the deadline passed
+         *
+         *  override to give up on work whose result would be dropped anyway, the deadline is ignored by default.
+         */
+        virtual boost::asio::awaitable<typename Ev::RetType, Executor> handle(const Ev& event, std::stop_token /* stop */) {
+            return handle(event);
+        }
+
+        /**
+         *  @brief this handler as a synchronous Handler, if it is one
+         *
+         *  dispatchers call synchronous handlers directly instead of through handle, which has to allocate a coroutine frame.
+         */
+        virtual Handler<Ev>* sync_handler() noexcept {
+            return nullptr;
+        }
+
         constexpr decltype(auto) operator<=>(const AsyncHandler& rhs) {
             return std::addressof(*this) <=> std::addressof(rhs);
         }
@@ -36,17 +59,32 @@ namespace tiara::core::event {
     struct Handler: public AsyncHandler<Ev> {
         virtual typename Ev::RetType handle(const Ev& event, sync_tag_t) = 0;
 
+        /**
+         *  @brief handle events delivered together in arrival order, results are discarded
+         *
+         *  override to process the whole span in one loop instead of one virtual call per event.
+         */
+        virtual void handle_batch(std::span<const Ev> events, sync_tag_t) {
+            for (const Ev& event: events) handle(event, sync_tag);
+        }
+
         boost::asio::awaitable<typename Ev::RetType, boost::asio::any_io_executor> handle(const Ev& event) final {
-            return ([this, &event]() -> boost::asio::awaitable<typename Ev::RetType, boost::asio::any_io_executor> { co_return handle(event, sync_tag); })();
+            co_return handle(event, sync_tag);
+        }
+
+        Handler* sync_handler() noexcept final {
+            return this;
         }
     };
 
     template <std::derived_from<Event> Ev, typename Executor, std::convertible_to<std::function<boost::asio::awaitable<typename Ev::RetType, Executor>(const Ev& event)>> F>
     class AsyncFunctionHandler: public AsyncHandler<Ev, Executor> {
-        AsyncFunctionHandler(F&& f): f(std::move(f)) {}
+        public:
+        AsyncFunctionHandler(F&& f): f(std::forward<F>(f)) {}
 
+        // hand out the awaitable of f as is rather than wrapping it in another coroutine frame
         boost::asio::awaitable<typename Ev::RetType, Executor> handle(const Ev& event) final {
-            f(event);
+            return f(event);
         }
 
         private:
@@ -4,23 +4,30 @@
 #include "tiara/core/stdincludes.hpp"
 #include "tiara/core/event/dispatcher.hpp"
 
+#include <unordered_map>
+
 namespace tiara::core::event {
 template <typename Ev, typename Executor, typename ParentHandler /* CRTP */>
 struct ManagedHandlerBase;
 
-template <typename Ev, typename Executor, typename ParentHandler /* CRTP */> requires std::derived_from<Ev, Event> && HandlerType<Ev, Executor, ParentHandler>
+template <typename Ev, typename Executor, typename ParentHandler /* CRTP */> requires std::derived_from<Ev, Event> && HandlerType<ParentHandler, Ev, Executor>
 struct ManagedHandlerBase<Ev, Executor, ParentHandler>
 {
-    std::vector<std::weak_ptr<AsyncDispatcher<Ev, Executor>>> _weak_subscribed_dispatchers;
+    std::unordered_map<const void*, std::weak_ptr<AsyncDispatcher<Ev, Executor>>> _weak_subscribed_dispatchers;
 };
 
-template <typename Ev, typename Executor, typename ParentHandler /* CRTP */> requires std::derived_from<Ev, Event> && HandlerType<Ev, Executor, ParentHandler> && std::derived_from<ParentHandler, Handler<Ev>>
+template <typename Ev, typename Executor, typename ParentHandler /* CRTP */> requires std::derived_from<Ev, Event> && HandlerType<ParentHandler, Ev, Executor> && std::derived_from<ParentHandler, Handler<Ev>>
 struct ManagedHandlerBase<Ev, Executor, ParentHandler>
 {
-    std::vector<std::weak_ptr<AsyncDispatcher<typename ParentHandler::EventType, typename ParentHandler::ExecutorType>>> _weak_subscribed_dispatchers;
-    std::vector<std::weak_ptr<Dispatcher<typename ParentHandler::EventType>>> _weak_subscribed_sync_dispatchers;
+    std::unordered_map<const void*, std::weak_ptr<AsyncDispatcher<Ev, Executor>>> _weak_subscribed_dispatchers;
+    std::unordered_map<const void*, std::weak_ptr<Dispatcher<Ev>>> _weak_subscribed_sync_dispatchers;
 };
 
+/**
+ *  @brief handler which unsubscribes itself from every dispatcher still alive on destruction
+ *
+ *  subscribed dispatchers are keyed by address so subscribe and unsubscribe are O(1)
+ */
 template <std::derived_from<Event> Ev, typename Executor, HandlerType<Ev, Executor> ParentHandler>
 class ManagedHandler: virtual public ParentHandler, private ManagedHandlerBase<Ev, Executor, ParentHandler> {
     private:
@@ -30,11 +37,11 @@ class ManagedHandler: virtual public ParentHandler, private ManagedHandlerBase<E
     ManagedHandler(Ts&&... args): ParentHandler{std::forward<Ts>(args)...} {}
 
     virtual ~ManagedHandler() {
-        for (auto _weak_dispatcher: Base::_weak_subscribed_dispatchers) {
+        for (auto& [_, _weak_dispatcher]: Base::_weak_subscribed_dispatchers) {
             if (auto _dispatcher = _weak_dispatcher.lock()) _dispatcher->stop_dispatch(static_cast<ParentHandler&>(*this));
         }
         if constexpr(std::derived_from<ParentHandler, Handler<Ev>>) {
-            for(auto _weak_sync_dispatcher: Base::_weak_subscribed_sync_dispatchers) {
+            for (auto& [_, _weak_sync_dispatcher]: Base::_weak_subscribed_sync_dispatchers) {
                 if (auto _sync_dispatcher = _weak_sync_dispatcher.lock()) _sync_dispatcher->stop_dispatch(static_cast<ParentHandler&>(*this));
             }
         }
@@ -42,36 +49,22 @@ class ManagedHandler: virtual public ParentHandler, private ManagedHandlerBase<E
     
     void subscribe(const std::shared_ptr<AsyncDispatcher<Ev, Executor>>& dispatcher) {
         dispatcher->start_dispatch(static_cast<ParentHandler&>(*this));
-        Base::_weak_subscribed_dispatchers.emplace_back(dispatcher);
+        Base::_weak_subscribed_dispatchers.insert_or_assign(dispatcher.get(), dispatcher);
     }
 
     void unsubscribe(const std::shared_ptr<AsyncDispatcher<Ev, Executor>>& dispatcher) {
         dispatcher->stop_dispatch(static_cast<ParentHandler&>(*this));
-        core::utils::remove_erase_if(
-            Base::_weak_subscribed_dispatchers,
-            [&dispatcher](const auto& _weak_dispatcher) {
-                auto _dispatcher = _weak_dispatcher.lock();
-                return (!_dispatcher) || (_dispatcher == dispatcher);
-            }
-        );
+        Base::_weak_subscribed_dispatchers.erase(dispatcher.get());
     }
 
-    template <std::enable_if_t<std::derived_from<ParentHandler, Handler<Ev>>, bool> = true>
-    void subscribe(const std::shared_ptr<Dispatcher<Ev>>& dispatcher) {
+    void subscribe(const std::shared_ptr<Dispatcher<Ev>>& dispatcher) requires std::derived_from<ParentHandler, Handler<Ev>> {
         dispatcher->start_dispatch(static_cast<ParentHandler&>(*this));
-        Base::_weak_subscribed_sync_dispatchers.emplace_back(dispatcher);
+        Base::_weak_subscribed_sync_dispatchers.insert_or_assign(dispatcher.get(), dispatcher);
     }
 
-    template <std::enable_if_t<std::derived_from<ParentHandler, Handler<Ev>>, bool> = true>
-    void unsubscribe(const std::shared_ptr<Dispatcher<Ev>>& dispatcher) {
+    void unsubscribe(const std::shared_ptr<Dispatcher<Ev>>& dispatcher) requires std::derived_from<ParentHandler, Handler<Ev>> {
         dispatcher->stop_dispatch(static_cast<ParentHandler&>(*this));
-        core::utils::remove_erase_if(
-            Base::_weak_subscribed_sync_dispatchers,
-            [&dispatcher](const auto& _weak_dispatcher) {
-                auto _dispatcher = _weak_dispatcher.lock();
-                return (!_dispatcher) || (_dispatcher == dispatcher);
-            }
-        );
+        Base::_weak_subscribed_sync_dispatchers.erase(dispatcher.get());
     }
 };
 }
@@ -0,0 +1,189 @@
+#ifndef TIARA_CORE_EVENT_RECORD
+#define TIARA_CORE_EVENT_RECORD
+
+#include "tiara/core/event/eventtype.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace tiara::core::event {
+    template <typename T>
+    concept RecordableEventType = std::derived_from<T, Event> && std::is_trivially_copyable_v<T> && std::default_initializable<T>;
+
+    enum class ReplaySpeed {
+        original, // wait between events as long as they were apart when recorded
+        maximum,  // deliver events back to back
+    };
+}
+
+namespace tiara::core::event::exceptions {
+    struct EventLogError: public std::runtime_error {
+        EventLogError(const std::string& description): std::runtime_error(description) {}
+    };
+}
+
+namespace tiara::core::event::detail {
+    static constexpr std::array<char, 8> event_log_magic{'T', 'I', 'A', 'R', 'A', 'E', 'V', '1'};
+
+    /**
+     *  @brief header of an event log, the event payloads are raw object bytes so logs are only portable between identical builds
+     */
+    template <RecordableEventType... Evs>
+    struct EventLogHeader {
+        std::array<char, 8> magic = event_log_magic;
+        uint32_t event_type_count = sizeof...(Evs);
+        std::array<uint32_t, sizeof...(Evs)> event_sizes{sizeof(Evs)...};
+
+        bool operator==(const EventLogHeader&) const = default;
+    };
+}
+
+namespace tiara::core::event {
+    /**
+     *  @brief write events to a compact binary log as (type tag, nanoseconds since recording started, payload) records
+     */
+    template <RecordableEventType... Evs>
+    class EventRecorder {
+        static_assert(sizeof...(Evs) <= 255, "event type tags are stored in a byte");
+
+        public:
+        explicit EventRecorder(const std::string& path):
+            _stream{path, std::ios::binary | std::ios::trunc},
+            _start{std::chrono::steady_clock::now()}
+        {
+            if (!_stream) throw exceptions::EventLogError{"cannot open event log for writing: " + path};
+            detail::EventLogHeader<Evs...> header;
+            _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        template <RecordableEventType Ev> requires (std::same_as<Ev, Evs> || ...)
+        void record(const Ev& event) {
+            uint8_t tag = _tag_of<Ev>();
+            int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+            _stream.write(reinterpret_cast<const char*>(&tag), sizeof(tag));
+            _stream.write(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+            _stream.write(reinterpret_cast<const char*>(&event), sizeof(Ev));
+            _recorded++;
+        }
+
+        std::size_t recorded() const noexcept {
+            return _recorded;
+        }
+
+        void flush() {
+            _stream.flush();
+        }
+
+        private:
+        template <typename Ev>
+        static constexpr uint8_t _tag_of() {
+            uint8_t tag = 0;
+            ((std::same_as<Ev, Evs> ? false : (tag++, true)) && ...);
+            return tag;
+        }
+
+        std::ofstream _stream;
+        std::chrono::steady_clock::time_point _start;
+        std::size_t _recorded = 0;
+    };
+
+    /**
+     *  @brief read back a log written by an EventRecorder with the same event types
+     */
+    template <RecordableEventType... Evs>
+    class EventReplayer {
+        public:
+        explicit EventReplayer(const std::string& path): _stream{path, std::ios::binary} {
+            if (!_stream) throw exceptions::EventLogError{"cannot open event log for reading: " + path};
+            detail::EventLogHeader<Evs...> header;
+            if (!_stream.read(reinterpret_cast<char*>(&header), sizeof(header)) || header != detail::EventLogHeader<Evs...>{}) {
+                throw exceptions::EventLogError{"event log was recorded with different event types: " + path};
+            }
+            _read_next();
+        }
+
+        bool done() const noexcept {
+            return !_has_next;
+        }
+
+        /**
+         *  @brief time of the next event since recording started
+         */
+        std::chrono::nanoseconds next_timestamp() const noexcept {
+            return std::chrono::nanoseconds{_next_timestamp};
+        }
+
+        /**
+         *  @brief pass every event recorded at most elapsed after recording started to f, returns the number of events passed
+         *
+         *  for driving a replay from a frame loop at original speed.
+         */
+        template <typename F> requires (std::invocable<F&, const Evs&> && ...)
+        std::size_t replay_until(std::chrono::nanoseconds elapsed, F&& f) {
+            std::size_t count = 0;
+            while (_has_next && next_timestamp() <= elapsed) {
+                _deliver_next(f);
+                count++;
+            }
+            _position = std::max(_position, elapsed);
+            return count;
+        }
+
+        /**
+         *  @brief pass every remaining event to f, blocking between events at original speed, returns the number of events passed
+         */
+        template <typename F> requires (std::invocable<F&, const Evs&> && ...)
+        std::size_t replay(F&& f, ReplaySpeed speed = ReplaySpeed::maximum) {
+            std::size_t count = 0;
+            // resume from where the previous replay stopped
+            auto start = std::chrono::steady_clock::now() - _position;
+            while (_has_next) {
+                if (speed == ReplaySpeed::original) std::this_thread::sleep_until(start + next_timestamp());
+                _deliver_next(f);
+                count++;
+            }
+            return count;
+        }
+
+        private:
+        void _read_next() {
+            _has_next =
+                _stream.read(reinterpret_cast<char*>(&_next_tag), sizeof(_next_tag)) &&
+                _stream.read(reinterpret_cast<char*>(&_next_timestamp), sizeof(_next_timestamp));
+            if (_has_next && _next_tag >= sizeof...(Evs)) throw exceptions::EventLogError{"unknown event tag"};
+        }
+
+        template <typename F>
+        void _deliver_next(F& f) {
+            uint8_t tag = 0;
+            bool read = ((tag++ == _next_tag ? _deliver_as<Evs>(f) : false) || ...);
+            if (!read) throw exceptions::EventLogError{"event log is truncated"};
+            _position = std::max(_position, next_timestamp());
+            _read_next();
+        }
+
+        template <typename Ev, typename F>
+        bool _deliver_as(F& f) {
+            Ev event;
+            if (!_stream.read(reinterpret_cast<char*>(&event), sizeof(Ev))) return false;
+            f(static_cast<const Ev&>(event));
+            return true;
+        }
+
+        std::ifstream _stream;
+        bool _has_next = false;
+        uint8_t _next_tag = 0;
+        int64_t _next_timestamp = 0;
+        std::chrono::nanoseconds _position{0};
+    };
+}
+
+#endif
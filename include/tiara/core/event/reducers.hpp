@@ -0,0 +1,106 @@
+#ifndef TIARA_CORE_EVENT_REDUCERS
+#define TIARA_CORE_EVENT_REDUCERS
+
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace tiara::core::event {
+    /**
+     *  @brief reducer folding handler results one at a time, reduce returns false to stop invoking further handlers
+     */
+    template <typename R, typename T>
+    concept ReducerType = requires (R reducer, typename R::ResultType& result, const T& value) {
+        { reducer.init() } -> std::convertible_to<typename R::ResultType>;
+        { reducer.reduce(result, value) } -> std::same_as<bool>;
+    };
+}
+
+namespace tiara::core::event::reducers {
+    /**
+     *  @brief true if any handler returned true, stops at the first one that did
+     */
+    struct any_of {
+        using ResultType = bool;
+
+        constexpr ResultType init() const noexcept {
+            return false;
+        }
+
+        template <typename T>
+        constexpr bool reduce(ResultType& result, const T& value) const {
+            if (!static_cast<bool>(value)) return true;
+            result = true;
+            return false;
+        }
+    };
+
+    /**
+     *  @brief true if every handler returned true, stops at the first one that did not
+     */
+    struct all_of {
+        using ResultType = bool;
+
+        constexpr ResultType init() const noexcept {
+            return true;
+        }
+
+        template <typename T>
+        constexpr bool reduce(ResultType& result, const T& value) const {
+            if (static_cast<bool>(value)) return true;
+            result = false;
+            return false;
+        }
+    };
+
+    /**
+     *  @brief index of the first handler that returned true (consumed the event), stops there
+     */
+    struct first_consumer {
+        using ResultType = std::optional<std::size_t>;
+
+        constexpr ResultType init() const noexcept {
+            return std::nullopt;
+        }
+
+        template <typename T>
+        constexpr bool reduce(ResultType& result, const T& value) {
+            if (!static_cast<bool>(value)) {
+                _index++;
+                return true;
+            }
+            result = _index;
+            return false;
+        }
+
+        private:
+        std::size_t _index = 0;
+    };
+
+    /**
+     *  @brief left fold of every handler result, equivalent to std::accumulate without materializing the results
+     */
+    template <typename InitType, typename Op>
+    struct fold {
+        using ResultType = InitType;
+
+        constexpr fold(InitType init, Op op): _init{std::move(init)}, _op{std::move(op)} {}
+
+        constexpr ResultType init() const {
+            return _init;
+        }
+
+        template <typename T>
+        constexpr bool reduce(ResultType& result, const T& value) {
+            result = _op(std::move(result), value);
+            return true;
+        }
+
+        private:
+        InitType _init;
+        Op _op;
+    };
+}
+
+#endif
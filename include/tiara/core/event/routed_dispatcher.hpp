@@ -0,0 +1,227 @@
+#ifndef TIARA_CORE_EVENT_ROUTED_DISPATCHER
+#define TIARA_CORE_EVENT_ROUTED_DISPATCHER
+
+#include "tiara/core/event/dispatcher.hpp"
+#include "tiara/core/utilities/concept_invocable.hpp"
+
+#include <functional>
+#include <unordered_map>
+
+namespace tiara::core::event {
+    /**
+     *  @brief token of a subscription made with a routing key
+     */
+    template <std::derived_from<Event> Ev, typename Key>
+    struct RoutedSubscription {
+        Key key;
+        Subscription<Ev> subscription;
+    };
+}
+
+namespace tiara::core::event::detail {
+    template <std::derived_from<Event> Ev>
+    struct RoutedHandlerEntry {
+        Handler<Ev>* handler;
+        // residual predicate checked after routing, empty if every event of the route is wanted
+        std::function<bool(const Ev&)> predicate;
+    };
+
+    /**
+     *  @brief handlers of a single event type indexed by routing key, so only handlers of the event's key are visited
+     *
+     *  the reentrancy guarantees of HandlerList hold within each route.
+     */
+    template <std::derived_from<Event> Ev, typename Key, typename Hash = std::hash<Key>>
+    class RoutedHandlerTable {
+        public:
+        RoutedSubscription<Ev, Key> subscribe(Handler<Ev>& h, const Key& key) {
+            return subscribe(h, key, std::function<bool(const Ev&)>{});
+        }
+
+        /**
+         *  @brief subscribe h to events routed to key which also satisfy pred, e.g. a utils::preds::combinators<const Ev&> predicate
+         */
+        template <utils::InvocableR<bool, const Ev&> Pred>
+        RoutedSubscription<Ev, Key> subscribe(Handler<Ev>& h, const Key& key, Pred pred) {
+            auto subscription = _routes[key].subscribe(h, std::function<bool(const Ev&)>{std::move(pred)});
+            _handler_routes.emplace(std::addressof(h), key);
+            return {key, subscription};
+        }
+
+        bool unsubscribe(const RoutedSubscription<Ev, Key>& subscription) {
+            auto route = _routes.find(subscription.key);
+            if (route == _routes.end()) return false;
+            Handler<Ev>* h = route->second.find(subscription.subscription);
+            if (!h) return false;
+            auto [begin, end] = _handler_routes.equal_range(h);
+            for (auto it = begin; it != end; it++) {
+                if (it->second == subscription.key) {
+                    _handler_routes.erase(it);
+                    break;
+                }
+            }
+            route->second.unsubscribe(subscription.subscription);
+            _erase_if_unused(route);
+            return true;
+        }
+
+        /**
+         *  @brief unsubscribe every routed subscription of h
+         */
+        void unsubscribe(Handler<Ev>& h) {
+            auto [begin, end] = _handler_routes.equal_range(std::addressof(h));
+            for (auto it = begin; it != end; it++) {
+                auto route = _routes.find(it->second);
+                if (route == _routes.end()) continue;
+                route->second.unsubscribe(h);
+                _erase_if_unused(route);
+            }
+            _handler_routes.erase(begin, end);
+        }
+
+        /**
+         *  @brief unsubscribe every handler routed to key, e.g. once the object key refers to is gone
+         */
+        void erase_route(const Key& key) {
+            auto route = _routes.find(key);
+            if (route == _routes.end()) return;
+            for (const auto& entry: route->second.handlers()) {
+                if (!entry.handler) continue;
+                auto [begin, end] = _handler_routes.equal_range(entry.handler);
+                for (auto it = begin; it != end;) {
+                    if (it->second == key) it = _handler_routes.erase(it);
+                    else it++;
+                }
+            }
+            if (!route->second.dispatching()) {
+                _routes.erase(route);
+                return;
+            }
+            // unsubscribing only clears entries while the route is dispatched, so the span stays valid
+            for (const auto& entry: route->second.handlers()) {
+                if (entry.handler) route->second.unsubscribe(*entry.handler);
+            }
+        }
+
+        bool is_subscribed(const RoutedSubscription<Ev, Key>& subscription) const noexcept {
+            auto route = _routes.find(subscription.key);
+            return route != _routes.end() && route->second.is_subscribed(subscription.subscription);
+        }
+
+        /**
+         *  @brief call f with each handler routed to key whose predicate accepts event until it returns false
+         */
+        template <utils::InvocableR<bool, Handler<Ev>&> F>
+        void for_each(const Key& key, const Ev& event, F&& f) {
+            auto route = _routes.find(key);
+            if (route == _routes.end()) return;
+            // references to map nodes stay valid when subscribing from f rehashes, iterators do not
+            HandlerList<Ev, RoutedHandlerEntry<Ev>>& handlers = route->second;
+            handlers.for_each(
+                [&event, &f](const RoutedHandlerEntry<Ev>& entry) {
+                    if (entry.predicate && !entry.predicate(event)) return true;
+                    return f(*entry.handler);
+                }
+            );
+            if (handlers.empty() && !handlers.dispatching()) _routes.erase(key);
+        }
+
+        std::size_t route_count() const noexcept {
+            return _routes.size();
+        }
+
+        private:
+        using RouteIterator = typename std::unordered_map<Key, HandlerList<Ev, RoutedHandlerEntry<Ev>>, Hash>::iterator;
+
+        void _erase_if_unused(RouteIterator route) {
+            // a route being dispatched is erased by its for_each once it returns
+            if (route->second.empty() && !route->second.dispatching()) _routes.erase(route);
+        }
+
+        std::unordered_map<Key, HandlerList<Ev, RoutedHandlerEntry<Ev>>, Hash> _routes;
+        std::unordered_multimap<Handler<Ev>*, Key> _handler_routes;
+    };
+}
+
+namespace tiara::core::event {
+    /**
+     *  @brief dispatcher routing each event only to handlers subscribed with the key KeyOf extracts from it
+     *
+     *  handlers subscribed without a key receive every event before the routed ones.
+     */
+    template <std::derived_from<Event> Ev, typename Key, utils::InvocableR<Key, const Ev&> KeyOf, typename Hash = std::hash<Key>>
+    struct RoutedDispatcher: public Dispatcher<Ev> {
+        public:
+        RoutedDispatcher() = default;
+        RoutedDispatcher(KeyOf key_of): _key_of{std::move(key_of)} {}
+
+        void start_dispatch(Handler<Ev>& h) override {
+            _handlers.subscribe(h);
+        }
+        /**
+         *  @brief unsubscribe h from every event, routed or not
+         */
+        void stop_dispatch(Handler<Ev>& h) override {
+            _handlers.unsubscribe(h);
+            _routes.unsubscribe(h);
+        }
+
+        Subscription<Ev> subscribe(Handler<Ev>& h) {
+            return _handlers.subscribe(h);
+        }
+        RoutedSubscription<Ev, Key> subscribe(Handler<Ev>& h, const Key& key) {
+            return _routes.subscribe(h, key);
+        }
+        template <utils::InvocableR<bool, const Ev&> Pred>
+        RoutedSubscription<Ev, Key> subscribe(Handler<Ev>& h, const Key& key, Pred pred) {
+            return _routes.subscribe(h, key, std::move(pred));
+        }
+
+        bool unsubscribe(Subscription<Ev> subscription) {
+            return _handlers.unsubscribe(subscription);
+        }
+        bool unsubscribe(const RoutedSubscription<Ev, Key>& subscription) {
+            return _routes.unsubscribe(subscription);
+        }
+
+        bool is_subscribed(Subscription<Ev> subscription) const noexcept {
+            return _handlers.is_subscribed(subscription);
+        }
+        bool is_subscribed(const RoutedSubscription<Ev, Key>& subscription) const noexcept {
+            return _routes.is_subscribed(subscription);
+        }
+
+        protected:
+        template <typename InitType> requires (!ReducerType<InitType, typename Ev::RetType>)
+        InitType dispatch(const Ev& event, const InitType& init) {
+            return dispatch(event, init, std::plus<>{});
+        }
+
+        template <typename InitType, std::invocable<const InitType&, const typename Ev::RetType&> Op>
+        InitType dispatch(const Ev& event, const InitType& init, Op op) {
+            return dispatch(event, reducers::fold<InitType, Op>{init, std::move(op)});
+        }
+
+        /**
+         *  @brief dispatch event to unrouted handlers then to handlers routed to its key, stopping once reducer returns false
+         */
+        template <ReducerType<typename Ev::RetType> Reducer>
+        typename Reducer::ResultType dispatch(const Ev& event, Reducer reducer) {
+            typename Reducer::ResultType result = reducer.init();
+            bool proceed = true;
+            auto reduce = [&event, &reducer, &result, &proceed](Handler<Ev>& h) {
+                return proceed = reducer.reduce(result, h.handle(event, core::event::sync_tag));
+            };
+            _handlers.for_each(reduce);
+            if (proceed) _routes.for_each(std::invoke(_key_of, event), event, reduce);
+            return result;
+        }
+
+        private:
+        KeyOf _key_of;
+        detail::HandlerList<Ev> _handlers;
+        detail::RoutedHandlerTable<Ev, Key, Hash> _routes;
+    };
+}
+
+#endif
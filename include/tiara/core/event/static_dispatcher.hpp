@@ -0,0 +1,98 @@
+#ifndef TIARA_CORE_EVENT_STATIC_DISPATCHER
+#define TIARA_CORE_EVENT_STATIC_DISPATCHER
+
+#include "tiara/core/event/handler.hpp"
+#include "tiara/core/event/reducers.hpp"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+namespace tiara::core::event {
+    template <typename T, typename Ev>
+    concept SyncHandlerType = std::derived_from<Ev, Event> && requires (T& handler, const Ev& event) {
+        { handler.handle(event, sync_tag) } -> std::convertible_to<typename Ev::RetType>;
+    };
+
+    /**
+     *  @brief dispatcher over a set of handlers fixed at compile time, owned by value and called without virtual dispatch
+     *
+     *  start_dispatch and stop_dispatch only enable or disable the owned handlers, other handlers are ignored
+     */
+    template <std::derived_from<Event> Ev, SyncHandlerType<Ev>... Hdlrs>
+    struct StaticDispatcher {
+        public:
+        StaticDispatcher() = default;
+
+        template <typename... Args> requires (sizeof...(Args) == sizeof...(Hdlrs)) && std::constructible_from<std::tuple<Hdlrs...>, Args...>
+        explicit StaticDispatcher(Args&&... args): _handlers{std::forward<Args>(args)...} {}
+
+        StaticDispatcher(const StaticDispatcher&) = delete;
+        StaticDispatcher& operator=(const StaticDispatcher&) = delete;
+
+        template <typename Hdlr>
+        void start_dispatch(Hdlr& h) {
+            _set_enabled(h, true);
+        }
+        template <typename Hdlr>
+        void stop_dispatch(Hdlr& h) {
+            _set_enabled(h, false);
+        }
+
+        template <std::size_t I>
+        std::tuple_element_t<I, std::tuple<Hdlrs...>>& handler() noexcept {
+            return std::get<I>(_handlers);
+        }
+        template <std::size_t I>
+        const std::tuple_element_t<I, std::tuple<Hdlrs...>>& handler() const noexcept {
+            return std::get<I>(_handlers);
+        }
+
+        protected:
+        template <typename InitType> requires (!ReducerType<InitType, typename Ev::RetType>)
+        InitType dispatch(const Ev& event, const InitType& init) {
+            return dispatch(event, init, std::plus<>{});
+        }
+
+        template <typename InitType, std::invocable<const InitType&, const typename Ev::RetType&> Op>
+        InitType dispatch(const Ev& event, const InitType& init, Op op) {
+            return dispatch(event, reducers::fold<InitType, Op>{init, std::move(op)});
+        }
+
+        template <ReducerType<typename Ev::RetType> Reducer>
+        typename Reducer::ResultType dispatch(const Ev& event, Reducer reducer) {
+            typename Reducer::ResultType result = reducer.init();
+            [this, &event, &reducer, &result]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((!_enabled[Is] || reducer.reduce(result, _handle<Is>(event))) && ...);
+            }(std::index_sequence_for<Hdlrs...>{});
+            return result;
+        }
+
+        private:
+        std::tuple<Hdlrs...> _handlers;
+        std::array<bool, sizeof...(Hdlrs)> _enabled = [](){
+            std::array<bool, sizeof...(Hdlrs)> enabled;
+            enabled.fill(true);
+            return enabled;
+        }();
+
+        template <std::size_t I>
+        typename Ev::RetType _handle(const Ev& event) {
+            using Hdlr = std::tuple_element_t<I, std::tuple<Hdlrs...>>;
+            // qualified call so handlers deriving from Handler<Ev> are not dispatched through their vtable
+            return std::get<I>(_handlers).Hdlr::handle(event, sync_tag);
+        }
+
+        template <typename Hdlr>
+        void _set_enabled(Hdlr& h, bool enabled) {
+            const void* address = static_cast<const void*>(std::addressof(h));
+            [this, address, enabled]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((static_cast<const void*>(std::addressof(std::get<Is>(_handlers))) == address ? (_enabled[Is] = enabled, 0) : 0), ...);
+            }(std::index_sequence_for<Hdlrs...>{});
+        }
+    };
+}
+
+#endif
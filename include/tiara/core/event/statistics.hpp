@@ -0,0 +1,172 @@
+#ifndef TIARA_CORE_EVENT_STATISTICS
+#define TIARA_CORE_EVENT_STATISTICS
+
+#include "tiara/core/event/config.hpp"
+#include "tiara/core/event/handler.hpp"
+#include "tiara/core/utilities/histogram.hpp"
+
+#include "spdlog/spdlog.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace tiara::core::event {
+    using LatencyHistogram = utils::LogLinearHistogram<>;
+
+    struct HandlerStatisticsSnapshot {
+        const void* handler;
+        const char* handler_type;
+        uint64_t calls;
+        uint64_t total_ns;
+        uint64_t p50_ns;
+        uint64_t p90_ns;
+        uint64_t p99_ns;
+        uint64_t max_ns;
+    };
+
+    struct EventStatisticsSnapshot {
+        const char* event_type;
+        uint64_t dispatches;
+        uint64_t handler_calls;
+        // filled by the dispatcher owning the statistics
+        std::size_t subscribed_handlers;
+        std::vector<HandlerStatisticsSnapshot> handlers;
+    };
+
+    /**
+     *  @brief dispatch counts and per-handler latencies of a single event type
+     *
+     *  recording must happen on the thread dispatching the events, snapshot and reset can be called from any thread.
+     */
+    template <std::derived_from<Event> Ev>
+    class EventStatistics {
+        public:
+        void record_dispatch(uint64_t count = 1) noexcept {
+            _dispatches.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        /**
+         *  @brief time a call of f as a call to h, returns the result of f
+         */
+        template <std::invocable F>
+        decltype(auto) record_handler_call(const Handler<Ev>& h, F&& f) {
+            LatencyHistogram& latency = _latency_of(h);
+            auto time_before = std::chrono::steady_clock::now();
+            struct Record {
+                ~Record() {
+                    latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_before).count()));
+                    if (--statistics._recording == 0 && !statistics._forgotten.empty()) statistics._forget_pending();
+                }
+                EventStatistics& statistics;
+                LatencyHistogram& latency;
+                std::chrono::steady_clock::time_point time_before;
+            } record{*this, latency, time_before};
+            _recording++;
+            _handler_calls.fetch_add(1, std::memory_order_relaxed);
+            return std::forward<F>(f)();
+        }
+
+        /**
+         *  @brief drop the latencies of h once it is unsubscribed, so a later handler at the same address starts afresh
+         *
+         *  must be called on the dispatching thread, if a handler call is being recorded h is dropped once it returns.
+         */
+        void forget_handler(const Handler<Ev>& h) {
+            if (_recording > 0) {
+                _forgotten.push_back(std::addressof(h));
+                return;
+            }
+            std::scoped_lock lock{_latencies_mutex};
+            _latencies.erase(std::addressof(h));
+        }
+
+        uint64_t dispatches() const noexcept {
+            return _dispatches.load(std::memory_order_relaxed);
+        }
+        uint64_t handler_calls() const noexcept {
+            return _handler_calls.load(std::memory_order_relaxed);
+        }
+
+        EventStatisticsSnapshot snapshot() const {
+            EventStatisticsSnapshot result{typeid(Ev).name(), dispatches(), handler_calls(), 0, {}};
+            std::scoped_lock lock{_latencies_mutex};
+            result.handlers.reserve(_latencies.size());
+            for (const auto& [handler, latency]: _latencies) {
+                result.handlers.push_back({
+                    handler,
+                    latency.handler_type,
+                    latency.histogram->count(),
+                    latency.histogram->sum(),
+                    latency.histogram->quantile(0.5),
+                    latency.histogram->quantile(0.9),
+                    latency.histogram->quantile(0.99),
+                    latency.histogram->max()
+                });
+            }
+            return result;
+        }
+
+        /**
+         *  @brief zero every counter, handlers stay listed until they are called again
+         */
+        void reset() noexcept {
+            _dispatches.store(0, std::memory_order_relaxed);
+            _handler_calls.store(0, std::memory_order_relaxed);
+            std::scoped_lock lock{_latencies_mutex};
+            for (auto& [handler, latency]: _latencies) latency.histogram->reset();
+        }
+
+        private:
+        struct HandlerLatency {
+            const char* handler_type;
+            // histograms are large, keep them out of the map nodes
+            std::unique_ptr<LatencyHistogram> histogram;
+        };
+
+        void _forget_pending() {
+            std::scoped_lock lock{_latencies_mutex};
+            for (const void* h: _forgotten) _latencies.erase(h);
+            _forgotten.clear();
+        }
+
+        LatencyHistogram& _latency_of(const Handler<Ev>& h) {
+            // only the dispatching thread inserts, so it can look up without locking
+            auto it = _latencies.find(std::addressof(h));
+            if (it != _latencies.end()) return *it->second.histogram;
+            std::scoped_lock lock{_latencies_mutex};
+            return *_latencies.emplace(std::addressof(h), HandlerLatency{typeid(h).name(), std::make_unique<LatencyHistogram>()}).first->second.histogram;
+        }
+
+        std::atomic<uint64_t> _dispatches{0};
+        std::atomic<uint64_t> _handler_calls{0};
+        mutable std::mutex _latencies_mutex;
+        std::unordered_map<const void*, HandlerLatency> _latencies;
+        // only touched by the dispatching thread
+        std::size_t _recording = 0;
+        std::vector<const void*> _forgotten;
+    };
+
+    /**
+     *  @brief log snapshot to logger at info level
+     */
+    inline void log_statistics(spdlog::logger& logger, const EventStatisticsSnapshot& snapshot) {
+        logger.info(
+            "{}: {} dispatches, {} handler calls, {} handlers subscribed",
+            snapshot.event_type, snapshot.dispatches, snapshot.handler_calls, snapshot.subscribed_handlers
+        );
+        for (const auto& handler: snapshot.handlers) {
+            logger.info(
+                "  {} ({}): {} calls, {} ns total, p50 {} ns, p90 {} ns, p99 {} ns, max {} ns",
+                handler.handler, handler.handler_type, handler.calls, handler.total_ns,
+                handler.p50_ns, handler.p90_ns, handler.p99_ns, handler.max_ns
+            );
+        }
+    }
+}
+
+#endif
@@ -3,8 +3,22 @@
 
 #include "tiara/core/utilities/is_tuple.hpp"
 
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#include <atomic>
 #include <concepts>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <typeinfo>
 
 namespace tiara::core::extension {
     struct ExtensionBase {
@@ -53,6 +67,98 @@ namespace tiara::core::extension {
             return detail::ExtensionInitHandle{std::unique_ptr<ExtensionBase>(new Ext{})};
         }
     };
+
+    /**
+     *  @brief Ext::Dependencies, the std::tuple of extensions Tiara initializes before Ext, or an empty tuple
+     */
+    template <typename Ext>
+    struct dependencies {
+        using type = std::tuple<>;
+    };
+    template <typename Ext> requires utils::TupleType<typename Ext::Dependencies>
+    struct dependencies<Ext> {
+        using type = typename Ext::Dependencies;
+    };
+    template <typename Ext>
+    using dependencies_t = typename dependencies<Ext>::type;
+
+    /**
+     *  @brief Ext::lazy, Ext is initialized by the first require<Ext>() instead of by Tiara::init
+     */
+    template <typename Ext>
+    constexpr bool is_lazy_v = requires { requires Ext::lazy; };
+
+    /**
+     *  @brief Ext::concurrent_init, Ext may be initialized on another thread alongside the extensions it does not depend on
+     *
+     *  off by default, as anything calling into glfw has to stay on the thread calling Tiara::init.
+     */
+    template <typename Ext>
+    constexpr bool is_concurrent_init_v = requires { requires Ext::concurrent_init; };
+}
+
+namespace tiara::core::extension::detail {
+    inline std::string _demangle(const char* name) {
+        #if defined(__GNUG__)
+        int status = 0;
+        std::unique_ptr<char, decltype(&std::free)> demangled{abi::__cxa_demangle(name, nullptr, nullptr, &status), &std::free};
+        if (status == 0 && demangled) return demangled.get();
+        #endif
+        return name;
+    }
+}
+
+namespace tiara::core::extension {
+    /**
+     *  @brief name of Ext in logs and the startup report, Ext::name if it has one or its demangled type name
+     */
+    template <typename Ext>
+    std::string extension_name() {
+        if constexpr (requires { { Ext::name } -> std::convertible_to<std::string_view>; }) return std::string{std::string_view{Ext::name}};
+        else return detail::_demangle(typeid(Ext).name());
+    }
+}
+
+namespace tiara::core::extension::exceptions {
+    struct ExtensionNotInitialized: public std::runtime_error {
+        ExtensionNotInitialized(const std::string& name): std::runtime_error("extension " + name + " is not initialized") {}
+    };
+}
+
+namespace tiara::core::extension::detail {
+    struct LazyExtensionState {
+        // set once Ext is known to be initialized, cleared by Tiara::deinit
+        std::atomic<bool> ready{false};
+        // set by Tiara::init for the lazy extensions of its pack
+        std::function<void()> init;
+    };
+
+    template <typename Ext>
+    inline LazyExtensionState lazy_extension_state;
+
+    // recursive as initializing a lazy extension requires its dependencies
+    inline std::recursive_mutex lazy_extension_mutex;
+}
+
+namespace tiara::core::extension {
+    /**
+     *  @brief initialize Ext now if it is a lazy extension of Tiara that was not used yet, cheap once it is initialized
+     *
+     *  throws exceptions::ExtensionNotInitialized if Ext is neither initialized nor lazy.
+     */
+    template <typename Ext>
+    void require() {
+        auto& state = detail::lazy_extension_state<Ext>;
+        if (state.ready.load(std::memory_order_acquire)) return;
+        std::scoped_lock lock{detail::lazy_extension_mutex};
+        if (state.ready.load(std::memory_order_relaxed)) return;
+        if (state.init) {
+            state.init();
+            state.ready.store(true, std::memory_order_release);
+        } else if (!Ext::is_init()) {
+            throw exceptions::ExtensionNotInitialized{extension_name<Ext>()};
+        }
+    }
 }
 
 #endif
@@ -0,0 +1,176 @@
+#ifndef TIARA_CORE_STARTUP
+#define TIARA_CORE_STARTUP
+
+#include "spdlog/spdlog.h"
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tiara::core {
+    struct StartupPhase {
+        std::string name;
+        // phases started while another is running on the same thread are one level deeper
+        std::size_t depth;
+        // since the report was restarted
+        std::chrono::nanoseconds start;
+        // zero for marks, and for phases still running
+        std::chrono::nanoseconds duration;
+        bool finished;
+        std::thread::id thread;
+    };
+
+    /**
+     *  @brief timeline of startup phases, restarted by Tiara::init, can be appended to from any thread
+     */
+    class StartupReport {
+        public:
+        /**
+         *  @brief running phase, finished when destroyed
+         */
+        class Phase {
+            public:
+            Phase(StartupReport& report, std::size_t index) noexcept: _report{&report}, _index{index} {
+                _depth++;
+            }
+
+            Phase(Phase&& rhs) noexcept: _report{std::exchange(rhs._report, nullptr)}, _index{rhs._index} {}
+            Phase& operator=(Phase&&) = delete;
+
+            ~Phase() {
+                if (!_report) return;
+                _depth--;
+                _report->_finish(_index);
+            }
+
+            private:
+            StartupReport* _report;
+            std::size_t _index;
+        };
+
+        void restart() {
+            std::scoped_lock lock{_mutex};
+            _origin = std::chrono::steady_clock::now();
+            _phases.clear();
+        }
+
+        [[nodiscard]] Phase time(std::string name) {
+            std::scoped_lock lock{_mutex};
+            _phases.push_back({std::move(name), _depth, _since_origin(), std::chrono::nanoseconds{0}, false, std::this_thread::get_id()});
+            return {*this, _phases.size() - 1};
+        }
+
+        /**
+         *  @brief time a phase only if none of the same name was recorded since the restart, e.g. the first swapchain creation
+         */
+        [[nodiscard]] std::optional<Phase> time_once(std::string name) {
+            std::scoped_lock lock{_mutex};
+            if (_find(name)) return std::nullopt;
+            _phases.push_back({std::move(name), _depth, _since_origin(), std::chrono::nanoseconds{0}, false, std::this_thread::get_id()});
+            return std::optional<Phase>{std::in_place, *this, _phases.size() - 1};
+        }
+
+        /**
+         *  @brief record a point in time, such as the first frame being presented
+         */
+        void mark(std::string name) {
+            std::scoped_lock lock{_mutex};
+            _phases.push_back({std::move(name), _depth, _since_origin(), std::chrono::nanoseconds{0}, true, std::this_thread::get_id()});
+        }
+
+        bool mark_once(std::string name) {
+            std::scoped_lock lock{_mutex};
+            if (_find(name)) return false;
+            _phases.push_back({std::move(name), _depth, _since_origin(), std::chrono::nanoseconds{0}, true, std::this_thread::get_id()});
+            return true;
+        }
+
+        /**
+         *  @brief every phase and mark in the order they started
+         */
+        std::vector<StartupPhase> phases() const {
+            std::scoped_lock lock{_mutex};
+            return _phases;
+        }
+
+        std::optional<StartupPhase> find(std::string_view name) const {
+            std::scoped_lock lock{_mutex};
+            if (auto phase = _find(name)) return *phase;
+            return std::nullopt;
+        }
+
+        std::chrono::nanoseconds elapsed() const {
+            std::scoped_lock lock{_mutex};
+            return _since_origin();
+        }
+
+        private:
+        std::chrono::nanoseconds _since_origin() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _origin);
+        }
+
+        const StartupPhase* _find(std::string_view name) const {
+            for (auto& phase: _phases) {
+                if (phase.name == name) return &phase;
+            }
+            return nullptr;
+        }
+
+        void _finish(std::size_t index) {
+            std::scoped_lock lock{_mutex};
+            // restarted while the phase was running
+            if (index >= _phases.size()) return;
+            _phases[index].duration = _since_origin() - _phases[index].start;
+            _phases[index].finished = true;
+        }
+
+        mutable std::mutex _mutex;
+        std::chrono::steady_clock::time_point _origin = std::chrono::steady_clock::now();
+        std::vector<StartupPhase> _phases;
+
+        static inline thread_local std::size_t _depth = 0;
+    };
+}
+
+namespace tiara::core::detail {
+    static inline StartupReport startup_report;
+}
+
+namespace tiara::core {
+    /**
+     *  @brief log the startup report once Tiara::init returns
+     */
+    static inline bool log_startup_report_after_init = false;
+
+    inline StartupReport& startup_report() {
+        return detail::startup_report;
+    }
+
+    /**
+     *  @brief log every phase of report to logger at info level, indented by depth
+     */
+    inline void log_startup_report(spdlog::logger& logger, const StartupReport& report) {
+        logger.info("startup report:");
+        for (const auto& phase: report.phases()) {
+            auto start_ms = std::chrono::duration<double, std::milli>(phase.start).count();
+            if (!phase.finished) {
+                logger.info("{:>10.3f} ms {:{}}{} (running)", start_ms, "", phase.depth * 2, phase.name);
+            } else if (phase.duration.count() == 0) {
+                logger.info("{:>10.3f} ms {:{}}{}", start_ms, "", phase.depth * 2, phase.name);
+            } else {
+                logger.info(
+                    "{:>10.3f} ms {:{}}{}: {:.3f} ms",
+                    start_ms, "", phase.depth * 2, phase.name, std::chrono::duration<double, std::milli>(phase.duration).count()
+                );
+            }
+        }
+    }
+}
+
+#endif
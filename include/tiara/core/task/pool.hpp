@@ -0,0 +1,227 @@
+#ifndef TIARA_CORE_TASK_POOL
+#define TIARA_CORE_TASK_POOL
+
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace tiara::core::task::detail {
+    struct TaskBase {
+        virtual ~TaskBase() = default;
+        virtual void run() = 0;
+    };
+
+    template <typename F>
+    struct TaskImpl final: TaskBase {
+        template <typename UF>
+        TaskImpl(UF&& uf): f{std::forward<UF>(uf)} {}
+
+        void run() override {
+            std::move(f)();
+        }
+
+        F f;
+    };
+
+    // move-only type erased task, asio handlers cannot be stored in std::function
+    using Task = std::unique_ptr<TaskBase>;
+
+    template <typename F>
+    Task make_task(F&& f) {
+        return std::make_unique<TaskImpl<std::decay_t<F>>>(std::forward<F>(f));
+    }
+}
+
+namespace tiara::core::task {
+    /**
+     *  @brief thread pool where each worker owns a deque of tasks and steals from the others once it runs out
+     *
+     *  tasks submitted from a worker go to the back of its own deque and are run newest first,
+     *  tasks submitted from other threads are spread over the workers. idle workers steal the oldest task of another worker.
+     */
+    class WorkStealingPool: public boost::asio::execution_context {
+        public:
+        class executor_type;
+
+        /**
+         *  @brief start worker_count workers, or one per hardware thread if 0
+         */
+        explicit WorkStealingPool(std::size_t worker_count = 0) {
+            if (worker_count == 0) worker_count = std::max(1u, std::thread::hardware_concurrency());
+            _workers.reserve(worker_count);
+            for (std::size_t i = 0; i < worker_count; i++) _workers.push_back(std::make_unique<Worker>());
+            _threads.reserve(worker_count);
+            for (std::size_t i = 0; i < worker_count; i++) _threads.emplace_back([this, i](){ _run(i); });
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        ~WorkStealingPool() {
+            join();
+            shutdown();
+            destroy();
+        }
+
+        executor_type get_executor() noexcept;
+
+        std::size_t worker_count() const noexcept {
+            return _workers.size();
+        }
+
+        /**
+         *  @brief run every task already submitted, then stop the workers and wait for them to exit
+         */
+        void join() {
+            {
+                std::scoped_lock lock{_sleep_mutex};
+                _stop = true;
+            }
+            _sleep_condition.notify_all();
+            for (auto& thread: _threads) {
+                if (thread.joinable()) thread.join();
+            }
+        }
+
+        /**
+         *  @brief whether the calling thread is one of the workers
+         */
+        bool running_in_this_thread() const noexcept {
+            return _current_pool == this;
+        }
+
+        template <typename F>
+        void submit(F&& f) {
+            detail::Task task = detail::make_task(std::forward<F>(f));
+            Worker& worker = running_in_this_thread() ?
+                *_workers[_current_worker] :
+                *_workers[_next_worker.fetch_add(1, std::memory_order_relaxed) % _workers.size()];
+            {
+                std::scoped_lock lock{worker.mutex};
+                worker.tasks.push_back(std::move(task));
+            }
+            _pending.fetch_add(1, std::memory_order_seq_cst);
+            if (_sleeping.load(std::memory_order_seq_cst) > 0) {
+                std::scoped_lock lock{_sleep_mutex};
+                _sleep_condition.notify_one();
+            }
+        }
+
+        private:
+        struct Worker {
+            std::mutex mutex;
+            std::deque<detail::Task> tasks;
+        };
+
+        detail::Task _pop(std::size_t index) {
+            Worker& worker = *_workers[index];
+            std::scoped_lock lock{worker.mutex};
+            if (worker.tasks.empty()) return nullptr;
+            detail::Task task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            return task;
+        }
+
+        detail::Task _steal(std::size_t thief) {
+            for (std::size_t offset = 1; offset < _workers.size(); offset++) {
+                Worker& victim = *_workers[(thief + offset) % _workers.size()];
+                std::unique_lock lock{victim.mutex, std::try_to_lock};
+                if (!lock || victim.tasks.empty()) continue;
+                detail::Task task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return task;
+            }
+            return nullptr;
+        }
+
+        void _run(std::size_t index) {
+            _current_pool = this;
+            _current_worker = index;
+            while (true) {
+                detail::Task task = _pop(index);
+                if (!task) task = _steal(index);
+                if (task) {
+                    _pending.fetch_sub(1, std::memory_order_relaxed);
+                    task->run();
+                    continue;
+                }
+                std::unique_lock lock{_sleep_mutex};
+                _sleeping.fetch_add(1, std::memory_order_seq_cst);
+                // pending tasks may only be visible to a steal that lost a try_lock, so wake up to retry
+                _sleep_condition.wait(lock, [this](){ return _pending.load(std::memory_order_seq_cst) > 0 || _stop; });
+                _sleeping.fetch_sub(1, std::memory_order_relaxed);
+                if (_stop && _pending.load(std::memory_order_seq_cst) == 0) break;
+            }
+            _current_pool = nullptr;
+        }
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::vector<std::thread> _threads;
+        std::atomic<std::size_t> _next_worker{0};
+        std::atomic<std::size_t> _pending{0};
+        std::atomic<std::size_t> _sleeping{0};
+        std::mutex _sleep_mutex;
+        std::condition_variable _sleep_condition;
+        bool _stop = false;
+
+        static inline thread_local const WorkStealingPool* _current_pool = nullptr;
+        static inline thread_local std::size_t _current_worker = 0;
+    };
+
+    /**
+     *  @brief asio executor submitting to a WorkStealingPool, usable as the Executor of AsyncHandler and co_spawn
+     */
+    class WorkStealingPool::executor_type {
+        public:
+        explicit executor_type(WorkStealingPool& pool) noexcept: _pool{&pool} {}
+
+        WorkStealingPool& context() const noexcept {
+            return *_pool;
+        }
+
+        boost::asio::execution_context& query(boost::asio::execution::context_t) const noexcept {
+            return *_pool;
+        }
+
+        static constexpr boost::asio::execution::blocking_t query(boost::asio::execution::blocking_t) noexcept {
+            return boost::asio::execution::blocking.never;
+        }
+
+        executor_type require(boost::asio::execution::blocking_t::never_t) const noexcept {
+            return *this;
+        }
+
+        template <typename F>
+        void execute(F&& f) const {
+            _pool->submit(std::forward<F>(f));
+        }
+
+        bool running_in_this_thread() const noexcept {
+            return _pool->running_in_this_thread();
+        }
+
+        bool operator==(const executor_type& rhs) const noexcept {
+            return _pool == rhs._pool;
+        }
+        bool operator!=(const executor_type& rhs) const noexcept {
+            return _pool != rhs._pool;
+        }
+
+        private:
+        WorkStealingPool* _pool;
+    };
+
+    inline WorkStealingPool::executor_type WorkStealingPool::get_executor() noexcept {
+        return executor_type{*this};
+    }
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef TIARA_CORE_TASK_TASK
+#define TIARA_CORE_TASK_TASK
+
+#include "tiara/core/core.hpp"
+#include "tiara/core/task/pool.hpp"
+
+#include <optional>
+
+namespace tiara::core::task {
+    // number of workers started by TaskExtension, 0 for one per hardware thread
+    inline std::size_t worker_count = 0;
+}
+
+namespace tiara::core::task::detail {
+    inline std::optional<WorkStealingPool> pool;
+}
+
+namespace tiara::core::task {
+    /**
+     *  @brief extension running the shared work stealing pool between Tiara init and deinit, started on first use
+     */
+    struct TaskExtension: public core::extension::Extension<TaskExtension> {
+        static constexpr bool lazy = true;
+        static constexpr bool concurrent_init = true;
+
+        virtual void init() final {
+            core::detail::logger->info("initializing tiara::core::task");
+            detail::pool.emplace(worker_count);
+            core::detail::logger->info("initialized tiara::core::task ({} workers)", detail::pool->worker_count());
+        }
+        virtual void deinit() final {
+            core::detail::logger->info("deinitializing tiara::core::task");
+            // runs the tasks already submitted before the workers exit
+            detail::pool.reset();
+            core::detail::logger->info("deinitialized tiara::core::task");
+        }
+        static bool is_init() {
+            return static_cast<bool>(detail::pool);
+        }
+    };
+
+    inline WorkStealingPool& pool() {
+        core::extension::require<TaskExtension>();
+        return detail::pool.value();
+    }
+
+    inline WorkStealingPool::executor_type executor() {
+        return pool().get_executor();
+    }
+}
+
+#endif
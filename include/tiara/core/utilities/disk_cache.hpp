@@ -0,0 +1,202 @@
+#ifndef TIARA_CORE_UTILITIES_DISK_CACHE
+#define TIARA_CORE_UTILITIES_DISK_CACHE
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace tiara::core::utils::detail {
+    static constexpr std::array<char, 8> disk_cache_magic{'T', 'I', 'A', 'R', 'A', 'C', 'H', '1'};
+
+    struct DiskCacheEntryHeader {
+        std::array<char, 8> magic = disk_cache_magic;
+        uint64_t key_size;
+        uint64_t data_size;
+    };
+
+    constexpr uint64_t _fnv1a(std::span<const std::byte> bytes) noexcept {
+        uint64_t hash = 0xcbf29ce484222325;
+        for (std::byte b: bytes) {
+            hash ^= static_cast<uint64_t>(b);
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    inline std::string _hex(uint64_t value) {
+        constexpr char digits[] = "0123456789abcdef";
+        std::string result(16, '0');
+        for (std::size_t i = 0; i < 16; i++) result[15 - i] = digits[(value >> (i * 4)) & 0xf];
+        return result;
+    }
+}
+
+namespace tiara::core::utils {
+    /**
+     *  @brief directory of key-value blobs capped in total size, safe against crashes and concurrent processes
+     *
+     *  every entry is a file written under a temporary name and renamed into place, so readers never see a partial entry.
+     *  once the cap is exceeded the least recently used entries are removed. filesystem errors are reported by return value,
+     *  a cache that cannot be written is simply a cache that misses.
+     */
+    class DiskCache {
+        public:
+        /**
+         *  @brief open or create the cache in directory, throws std::filesystem::filesystem_error if it cannot be created
+         */
+        DiskCache(std::filesystem::path directory, std::uintmax_t max_bytes):
+            _directory{std::move(directory)},
+            _max_bytes{max_bytes}
+        {
+            std::filesystem::create_directories(_directory);
+            std::error_code error;
+            for (auto& entry: std::filesystem::directory_iterator{_directory, error}) {
+                // left behind by a writer that died before renaming
+                if (entry.path().extension() == ".tmp") std::filesystem::remove(entry.path(), error);
+                else if (entry.path().extension() == ".bin") _size += entry.file_size(error);
+            }
+        }
+
+        DiskCache(const DiskCache&) = delete;
+        DiskCache& operator=(const DiskCache&) = delete;
+
+        std::optional<std::vector<std::byte>> load(std::span<const std::byte> key) {
+            auto path = _path_of(key);
+            std::ifstream stream{path, std::ios::binary | std::ios::ate};
+            if (!stream) return std::nullopt;
+            // size of the opened file rather than of path, which a concurrent store may have replaced since
+            auto file_size = static_cast<uint64_t>(stream.tellg());
+            if (!stream.seekg(0)) return std::nullopt;
+            detail::DiskCacheEntryHeader header;
+            if (
+                !stream.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+                header.magic != detail::disk_cache_magic ||
+                header.key_size != key.size() ||
+                // a truncated or corrupt entry must not make us allocate whatever size it claims
+                file_size - sizeof(header) < key.size() ||
+                header.data_size != file_size - sizeof(header) - key.size()
+            ) return std::nullopt;
+            std::vector<std::byte> stored_key(key.size());
+            if (!stream.read(reinterpret_cast<char*>(stored_key.data()), stored_key.size())) return std::nullopt;
+            // hash collision
+            if (!std::ranges::equal(stored_key, key)) return std::nullopt;
+            std::vector<std::byte> data(header.data_size);
+            if (!stream.read(reinterpret_cast<char*>(data.data()), data.size())) return std::nullopt;
+
+            // entries are evicted by modification time, so a hit refreshes it
+            std::error_code error;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+            return data;
+        }
+
+        bool store(std::span<const std::byte> key, std::span<const std::byte> data) {
+            auto path = _path_of(key);
+            auto temporary_path = path;
+            temporary_path += "." + detail::_hex(std::hash<std::thread::id>{}(std::this_thread::get_id()) ^ _temporary_count.fetch_add(1)) + ".tmp";
+            {
+                std::ofstream stream{temporary_path, std::ios::binary | std::ios::trunc};
+                detail::DiskCacheEntryHeader header{.key_size = key.size(), .data_size = data.size()};
+                stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                stream.write(reinterpret_cast<const char*>(key.data()), key.size());
+                stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+                stream.close();
+                if (!stream) {
+                    std::error_code error;
+                    std::filesystem::remove(temporary_path, error);
+                    return false;
+                }
+            }
+
+            std::scoped_lock lock{_mutex};
+            std::error_code error;
+            std::uintmax_t replaced_size = std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+            if (error) replaced_size = 0;
+            std::filesystem::rename(temporary_path, path, error);
+            if (error) {
+                std::filesystem::remove(temporary_path, error);
+                return false;
+            }
+            _size = _size - std::min(_size, replaced_size) + sizeof(detail::DiskCacheEntryHeader) + key.size() + data.size();
+            if (_size > _max_bytes) _evict();
+            return true;
+        }
+
+        /**
+         *  @brief remove every entry
+         */
+        void clear() {
+            std::scoped_lock lock{_mutex};
+            std::error_code error;
+            for (auto& entry: std::filesystem::directory_iterator{_directory, error}) {
+                if (entry.path().extension() == ".bin") std::filesystem::remove(entry.path(), error);
+            }
+            _size = 0;
+        }
+
+        /**
+         *  @brief total size of the entries written or found by this instance, other processes may have changed it since
+         */
+        std::uintmax_t size() const {
+            std::scoped_lock lock{_mutex};
+            return _size;
+        }
+
+        std::uintmax_t max_bytes() const noexcept {
+            return _max_bytes;
+        }
+
+        const std::filesystem::path& directory() const noexcept {
+            return _directory;
+        }
+
+        private:
+        std::filesystem::path _path_of(std::span<const std::byte> key) const {
+            return _directory / (detail::_hex(detail::_fnv1a(key)) + ".bin");
+        }
+
+        void _evict() {
+            struct Entry {
+                std::filesystem::path path;
+                std::filesystem::file_time_type last_write_time;
+                std::uintmax_t size;
+            };
+            std::vector<Entry> entries;
+            std::error_code error;
+            for (auto& entry: std::filesystem::directory_iterator{_directory, error}) {
+                if (entry.path().extension() != ".bin") continue;
+                entries.push_back({entry.path(), entry.last_write_time(error), entry.file_size(error)});
+            }
+            std::ranges::sort(entries, {}, &Entry::last_write_time);
+
+            // recount from the directory, other processes may share it
+            _size = 0;
+            for (auto& entry: entries) _size += entry.size;
+            // leave some headroom so the next few stores do not each scan the directory again
+            std::uintmax_t target = _max_bytes - _max_bytes / 4;
+            for (auto& entry: entries) {
+                if (_size <= target) break;
+                if (std::filesystem::remove(entry.path, error)) _size -= entry.size;
+            }
+        }
+
+        std::filesystem::path _directory;
+        std::uintmax_t _max_bytes;
+        mutable std::mutex _mutex;
+        std::uintmax_t _size = 0;
+        std::atomic<uint64_t> _temporary_count{0};
+    };
+}
+
+#endif
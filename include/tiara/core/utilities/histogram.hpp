@@ -0,0 +1,95 @@
+#ifndef TIARA_CORE_UTILITIES_HISTOGRAM
+#define TIARA_CORE_UTILITIES_HISTOGRAM
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+namespace tiara::core::utils {
+    /**
+     *  @brief lock-free histogram of unsigned values with power of two buckets each split into linear sub-buckets
+     *
+     *  recording is wait-free and can happen concurrently with reading, the relative error of a bucket is at most 1/2^SubBucketBits.
+     */
+    template <unsigned SubBucketBits = 4>
+    class LogLinearHistogram {
+        public:
+        static constexpr std::size_t sub_bucket_count = std::size_t{1} << SubBucketBits;
+        static constexpr std::size_t bucket_count = (64 - SubBucketBits + 1) * sub_bucket_count;
+
+        void record(uint64_t value) noexcept {
+            _buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+            _count.fetch_add(1, std::memory_order_relaxed);
+            _sum.fetch_add(value, std::memory_order_relaxed);
+            uint64_t max = _max.load(std::memory_order_relaxed);
+            while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+        }
+
+        uint64_t count() const noexcept {
+            return _count.load(std::memory_order_relaxed);
+        }
+        uint64_t sum() const noexcept {
+            return _sum.load(std::memory_order_relaxed);
+        }
+        uint64_t max() const noexcept {
+            return _max.load(std::memory_order_relaxed);
+        }
+
+        uint64_t bucket(std::size_t index) const noexcept {
+            return _buckets[index].load(std::memory_order_relaxed);
+        }
+
+        /**
+         *  @brief upper bound of the bucket containing the q-th quantile (0 <= q <= 1), 0 if nothing is recorded
+         */
+        uint64_t quantile(double q) const noexcept {
+            uint64_t total = count();
+            if (total == 0) return 0;
+            uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < bucket_count; i++) {
+                seen += bucket(i);
+                if (seen >= rank) return std::min(bucket_upper_bound(i), max());
+            }
+            return max();
+        }
+
+        /**
+         *  @brief zero every counter, values recorded concurrently may be partially kept
+         */
+        void reset() noexcept {
+            for (auto& bucket: _buckets) bucket.store(0, std::memory_order_relaxed);
+            _count.store(0, std::memory_order_relaxed);
+            _sum.store(0, std::memory_order_relaxed);
+            _max.store(0, std::memory_order_relaxed);
+        }
+
+        static constexpr std::size_t bucket_index(uint64_t value) noexcept {
+            if (value < sub_bucket_count) return static_cast<std::size_t>(value);
+            unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - SubBucketBits;
+            return (shift + 1) * sub_bucket_count + static_cast<std::size_t>((value >> shift) - sub_bucket_count);
+        }
+
+        static constexpr uint64_t bucket_lower_bound(std::size_t index) noexcept {
+            if (index < sub_bucket_count) return index;
+            unsigned shift = static_cast<unsigned>(index / sub_bucket_count) - 1;
+            return (static_cast<uint64_t>(index % sub_bucket_count) + sub_bucket_count) << shift;
+        }
+
+        static constexpr uint64_t bucket_upper_bound(std::size_t index) noexcept {
+            if (index < sub_bucket_count) return index;
+            unsigned shift = static_cast<unsigned>(index / sub_bucket_count) - 1;
+            return bucket_lower_bound(index) + ((uint64_t{1} << shift) - 1);
+        }
+
+        private:
+        std::array<std::atomic<uint64_t>, bucket_count> _buckets{};
+        std::atomic<uint64_t> _count{0};
+        std::atomic<uint64_t> _sum{0};
+        std::atomic<uint64_t> _max{0};
+    };
+}
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef TIARA_CORE_UTILITIES_MPSC_QUEUE
+#define TIARA_CORE_UTILITIES_MPSC_QUEUE
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace tiara::core::utils {
+    /**
+     *  @brief bounded lock-free multi-producer single-consumer ring buffer
+     *
+     *  any thread may call try_emplace, only the owning thread may call try_pop/drain.
+     *  capacity is rounded up to a power of two and allocated once on construction.
+     */
+    template <typename T>
+    class BoundedMPSCQueue {
+        public:
+        explicit BoundedMPSCQueue(std::size_t capacity):
+            _mask{std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1},
+            _cells{std::make_unique<Cell[]>(_mask + 1)}
+        {
+            for (std::size_t i = 0; i <= _mask; i++) _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        BoundedMPSCQueue(const BoundedMPSCQueue&) = delete;
+        BoundedMPSCQueue& operator=(const BoundedMPSCQueue&) = delete;
+
+        ~BoundedMPSCQueue() {
+            while (_pop_with([](T&&){}));
+        }
+
+        /**
+         *  @brief construct an element in place, returns false without blocking if the queue is full
+         */
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            std::size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+            Cell* cell;
+            while (true) {
+                cell = &_cells[pos & _mask];
+                std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+                if (diff == 0) {
+                    if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = _enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            new (cell->storage) T(std::forward<Args>(args)...);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_pop(T& out) {
+            return _pop_with([&out](T&& value){ out = std::move(value); });
+        }
+
+        /**
+         *  @brief pop at most max_count elements and pass each to f, returns the number of elements popped
+         */
+        template <std::invocable<T&&> F>
+        std::size_t drain(F&& f, std::size_t max_count) {
+            std::size_t count = 0;
+            while (count < max_count && _pop_with(f)) count++;
+            return count;
+        }
+
+        std::size_t capacity() const noexcept {
+            return _mask + 1;
+        }
+
+        private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+        };
+
+        template <typename F>
+        bool _pop_with(F&& f) {
+            Cell& cell = _cells[_dequeue_pos & _mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(_dequeue_pos + 1) < 0) return false;
+            T* value = std::launder(reinterpret_cast<T*>(cell.storage));
+            // release the cell even if f throws so the queue stays usable
+            struct CellRelease {
+                Cell& cell;
+                T* value;
+                std::size_t next_sequence;
+                ~CellRelease() {
+                    value->~T();
+                    cell.sequence.store(next_sequence, std::memory_order_release);
+                }
+            } release{cell, value, _dequeue_pos + _mask + 1};
+            _dequeue_pos++;
+            f(std::move(*value));
+            return true;
+        }
+
+        const std::size_t _mask;
+        std::unique_ptr<Cell[]> _cells;
+        alignas(64) std::atomic<std::size_t> _enqueue_pos{0};
+        alignas(64) std::size_t _dequeue_pos{0};
+    };
+}
+
+#endif
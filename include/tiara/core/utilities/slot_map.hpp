@@ -0,0 +1,178 @@
+#ifndef TIARA_CORE_UTILITIES_SLOT_MAP
+#define TIARA_CORE_UTILITIES_SLOT_MAP
+
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tiara::core::utils {
+    struct SlotMapKey {
+        static constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+        uint32_t index = invalid_index;
+        uint32_t generation = 0;
+
+        constexpr auto operator<=>(const SlotMapKey&) const = default;
+    };
+
+    /**
+     *  @brief container with O(1) insertion, erasure and lookup by generational key, storing values contiguously in insertion order
+     *
+     *  erasing leaves a tombstone in place of the value so the others keep their order, values() and iteration still include
+     *  tombstoned values until compact() removes them in a single stable pass.
+     *  keys of erased values are detected as stale even after their slot is reused.
+     */
+    template <typename T>
+    class SlotMap {
+        public:
+        using Key = SlotMapKey;
+
+        template <typename... Args>
+        Key emplace(Args&&... args) {
+            _values.emplace_back(std::forward<Args>(args)...);
+            uint32_t dense_index = static_cast<uint32_t>(_values.size() - 1);
+            uint32_t slot_index;
+            if (_free_head != Key::invalid_index) {
+                slot_index = _free_head;
+                _free_head = _slots[slot_index].index;
+                _slots[slot_index].index = dense_index;
+            } else {
+                slot_index = static_cast<uint32_t>(_slots.size());
+                _slots.push_back({dense_index, 0});
+            }
+            _value_slots.push_back(slot_index);
+            return {slot_index, _slots[slot_index].generation};
+        }
+
+        bool erase(Key key) {
+            if (!contains(key)) return false;
+            _value_slots[_slots[key.index].index] = Key::invalid_index;
+            _free_slot(key.index);
+            _tombstones++;
+            return true;
+        }
+
+        /**
+         *  @brief erase every value satisfying pred and drop every tombstone in a single stable pass, returns the number erased
+         */
+        template <typename Pred>
+        std::size_t erase_if(Pred pred) {
+            std::size_t erased = 0;
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < _values.size(); i++) {
+                if (_value_slots[i] == Key::invalid_index) continue;
+                if (pred(static_cast<const T&>(_values[i]))) {
+                    _free_slot(_value_slots[i]);
+                    erased++;
+                    continue;
+                }
+                if (kept != i) {
+                    _values[kept] = std::move(_values[i]);
+                    _value_slots[kept] = _value_slots[i];
+                }
+                _slots[_value_slots[kept]].index = static_cast<uint32_t>(kept);
+                kept++;
+            }
+            _values.erase(_values.begin() + kept, _values.end());
+            _value_slots.resize(kept);
+            _tombstones = 0;
+            return erased;
+        }
+
+        /**
+         *  @brief remove the tombstones left by erase, moving the values after them down
+         */
+        void compact() {
+            erase_if([](const T&) { return false; });
+        }
+
+        /**
+         *  @brief number of erased values still taking space in values()
+         */
+        std::size_t tombstones() const noexcept {
+            return _tombstones;
+        }
+
+        /**
+         *  @brief whether the value at dense position dense_index was erased
+         */
+        bool is_tombstone(std::size_t dense_index) const noexcept {
+            return _value_slots[dense_index] == Key::invalid_index;
+        }
+
+        bool contains(Key key) const noexcept {
+            return key.index < _slots.size() && _slots[key.index].generation == key.generation;
+        }
+
+        T* find(Key key) noexcept {
+            return contains(key) ? &_values[_slots[key.index].index] : nullptr;
+        }
+        const T* find(Key key) const noexcept {
+            return contains(key) ? &_values[_slots[key.index].index] : nullptr;
+        }
+
+        /**
+         *  @brief key of the value currently at dense position dense_index, an invalid key for a tombstone
+         */
+        Key key_at(std::size_t dense_index) const noexcept {
+            uint32_t slot_index = _value_slots[dense_index];
+            if (slot_index == Key::invalid_index) return {};
+            return {slot_index, _slots[slot_index].generation};
+        }
+
+        std::span<T> values() noexcept {
+            return _values;
+        }
+        std::span<const T> values() const noexcept {
+            return _values;
+        }
+
+        auto begin() noexcept { return _values.begin(); }
+        auto end() noexcept { return _values.end(); }
+        auto begin() const noexcept { return _values.begin(); }
+        auto end() const noexcept { return _values.end(); }
+
+        /**
+         *  @brief number of values not erased, values() is larger by tombstones()
+         */
+        std::size_t size() const noexcept {
+            return _values.size() - _tombstones;
+        }
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+
+        void clear() {
+            for (auto slot_index: _value_slots) {
+                if (slot_index != Key::invalid_index) _free_slot(slot_index);
+            }
+            _values.clear();
+            _value_slots.clear();
+            _tombstones = 0;
+        }
+
+        private:
+        void _free_slot(uint32_t slot_index) noexcept {
+            _slots[slot_index].generation++;
+            _slots[slot_index].index = _free_head;
+            _free_head = slot_index;
+        }
+
+        struct Slot {
+            // index into _values when occupied, next free slot when free
+            uint32_t index;
+            uint32_t generation;
+        };
+
+        std::vector<T> _values;
+        std::vector<uint32_t> _value_slots;
+        std::vector<Slot> _slots;
+        uint32_t _free_head = Key::invalid_index;
+        std::size_t _tombstones = 0;
+    };
+}
+
+#endif
@@ -3,14 +3,18 @@
 
 #include "tiara/core/core.hpp"
 #include "tiara/core/utilities/predicate_combinators.hpp"
+#include "tiara/wm/skia_cache.hpp"
 
 #include "skia/gpu/GrDirectContext.h"
 #include "skia/gpu/vk/GrVkBackendContext.h"
 #include "skia/gpu/vk/GrVkExtensions.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 
+#include <future>
+
 namespace tiara::wm::detail {
-    static inline auto logger = spdlog::stdout_color_st("tiara::wm");
+    // also logs from the device prewarm thread
+    static inline auto logger = spdlog::stdout_color_mt("tiara::wm");
 }
 
 namespace tiara::wm::exceptions {
@@ -23,12 +27,27 @@ namespace tiara::wm::exceptions {
 
 namespace tiara::wm {
     static inline std::vector<std::string> vulkan_device_extensions{"VK_KHR_swapchain"};
+    /**
+     *  @brief device extensions enabled when the selected device has them
+     */
+    static inline std::vector<std::string> optional_vulkan_device_extensions{"VK_KHR_incremental_present"};
     static inline vk::PhysicalDeviceFeatures vulkan_device_features{};
     static inline std::shared_ptr<vk::raii::PhysicalDevice> preferred_physical_device;
     static inline std::optional<core::Queue> present_queue;
     static inline std::optional<GrVkExtensions> skia_vulkan_extensions;
     static inline std::optional<GrVkBackendContext> skia_vulkan_context;
     static inline sk_sp<GrDirectContext> skia_context;
+
+    /**
+     *  @brief have WMExtension select the device and create the skia context on a background thread, so the first window only checks its surface
+     */
+    static inline bool prewarm_device = false;
+}
+
+namespace tiara::wm::detail {
+    static inline std::future<void> prewarm_result;
+    // present_queue was selected without a surface, and may not be able to present to the first one
+    static inline bool prewarmed = false;
 }
 
 namespace tiara::wm::detail {
@@ -38,6 +57,7 @@ namespace tiara::wm::detail {
     }
 
     void _setup_skia() {
+        auto phase = core::detail::startup_report.time("skia setup");
         auto& ctx = core::context();
         detail::logger->debug("initializing skia");
         skia_vulkan_extensions
@@ -51,6 +71,18 @@ namespace tiara::wm::detail {
                 present_queue->device().extensions().size(),
                 present_queue->device().extensions().data()
             );
+        GrContextOptions skia_options;
+        if (skia_cache_directory) {
+            auto directory = detail::_skia_cache_directory_for(*skia_cache_directory, core::device_capabilities(present_queue->device().physical()).properties);
+            try {
+                detail::skia_persistent_cache = std::make_unique<detail::SkiaPersistentCache>(directory, skia_cache_max_bytes);
+                detail::_remove_stale_skia_caches(directory);
+                skia_options.fPersistentCache = detail::skia_persistent_cache.get();
+                detail::logger->debug("using skia cache {} ({} bytes)", directory.string(), detail::skia_persistent_cache->cache().size());
+            } catch (const std::filesystem::filesystem_error& e) {
+                detail::logger->warn("cannot use skia cache {}: {}", directory.string(), e.what());
+            }
+        }
         skia_context = GrDirectContext::MakeVulkan(
             skia_vulkan_context.emplace(
                 GrVkBackendContext {
@@ -64,30 +96,34 @@ namespace tiara::wm::detail {
                     .fDeviceFeatures = reinterpret_cast<VkPhysicalDeviceFeatures*>(&vulkan_device_features),
                     .fGetProc = detail::_skia_get_vk_proc
                 }
-            )
+            ),
+            skia_options
         );
         detail::logger->debug("initialized skia");
     }
 }
 
-namespace tiara::wm {
-    std::optional<core::Queue> select_queue_for_surface(std::shared_ptr<vk::raii::PhysicalDevice> physical_device, vk::SurfaceKHR surface) {
-        auto& physical_device_ref = *physical_device;
+namespace tiara::wm::detail {
+    template <core::utils::InvocableR<bool, uint32_t, const vk::QueueFamilyProperties&> QueueFamilyFilterFunc>
+    std::optional<core::Queue> _select_queue(std::shared_ptr<vk::raii::PhysicalDevice> physical_device, QueueFamilyFilterFunc&& queue_filter) {
         std::vector<float> queue_priority = {1.0};
         auto queue_families = core::find_queue_families(
-            physical_device_ref, 
+            *physical_device, 
             core::utils::preds::combinators<uint32_t, const vk::QueueFamilyProperties&>::make_and_(
                 core::simple_queue_filter(vk::QueueFlagBits::eGraphics), 
-                [&physical_device_ref, &surface](uint32_t queue_index, const vk::QueueFamilyProperties&) -> bool {
-                    return physical_device_ref.getSurfaceSupportKHR(queue_index, surface);
-                }
+                std::forward<QueueFamilyFilterFunc>(queue_filter)
             ),
             detail::logger
         );
         if (queue_families.empty()) return std::nullopt;
+        auto device_extensions = vulkan_device_extensions;
+        const auto& capabilities = core::device_capabilities(*physical_device);
+        for (const auto& extension: optional_vulkan_device_extensions) {
+            if (capabilities.has_extension(extension)) device_extensions.push_back(extension);
+        }
         auto device_queue_pair = core::create_queues_from_device(
             physical_device,
-            vulkan_device_extensions,
+            device_extensions,
             vulkan_device_features,
             {
                 {
@@ -100,74 +136,178 @@ namespace tiara::wm {
         return {std::move(device_queue_pair.second[0][0])};
     }
 
-    void select_device_queue_for_surface(vk::SurfaceKHR surface) {
-        if (!present_queue) {
-            if (preferred_physical_device) present_queue = select_queue_for_surface(preferred_physical_device, surface);
+    /**
+     *  @brief set present_queue to the queue of the best device passing device_filter that queue_select finds a queue on
+     */
+    template <
+        core::utils::InvocableR<bool, const core::DevicePropertiesPair&> DeviceFilterFunc,
+        core::utils::InvocableR<std::optional<core::Queue>, std::shared_ptr<vk::raii::PhysicalDevice>> QueueSelectFunc
+    >
+    void _select_device_queue(DeviceFilterFunc&& device_filter, QueueSelectFunc&& queue_select) {
+        {
+            auto phase = core::detail::startup_report.time("device selection");
+            if (preferred_physical_device) present_queue = queue_select(preferred_physical_device);
             else {
-                std::vector<std::string> required_extension_names{vulkan_device_extensions};
-                std::ranges::sort(required_extension_names);
-
                 for (
                     auto&& physical_device: 
                     core::find_devices(
                         core::utils::preds::combinators<const core::DevicePropertiesPair&>::make_and_(
-                            [&required_extension_names](const core::DevicePropertiesPair& physical_device_properties) {
-                                auto extension_properties_s = physical_device_properties.first.enumerateDeviceExtensionProperties();
-                                std::vector<std::string> extension_names;
-                                extension_names.reserve(extension_properties_s.size());
-
-                                std::ranges::transform(
-                                    extension_properties_s,
-                                    std::back_inserter(extension_names),
-                                    [](const vk::ExtensionProperties& extension_properties) -> std::string {
-                                        return extension_properties.extensionName;
-                                    }
-                                );
-
-                                std::ranges::sort(extension_names);
-
-                                return std::ranges::includes(extension_names, required_extension_names);
-                            },
-                            [surface](const core::DevicePropertiesPair& physical_device_properties) {
-                                return !physical_device_properties.first.getSurfaceFormatsKHR(surface).empty();
+                            [](const core::DevicePropertiesPair& physical_device_properties) {
+                                return core::device_capabilities(physical_device_properties.first).has_extensions(vulkan_device_extensions);
                             },
-                            [surface](const core::DevicePropertiesPair& physical_device_properties) {
-                                return !physical_device_properties.first.getSurfacePresentModesKHR(surface).empty();
-                            }
+                            std::forward<DeviceFilterFunc>(device_filter)
                         ),
                         core::simple_device_comparer,
                         detail::logger
                     )
                 ) {
-                    present_queue = select_queue_for_surface(std::make_shared<vk::raii::PhysicalDevice>(std::move(physical_device)), surface);
+                    present_queue = queue_select(std::make_shared<vk::raii::PhysicalDevice>(std::move(physical_device)));
                     if (present_queue) break;
                 }
             }
+        }
 
-            if (present_queue) {
-                detail::_setup_skia();
-
-                if (detail::logger->level() <= spdlog::level::debug) {
-                    detail::logger->debug("selected physical device:");
-                    auto physical_device_property = present_queue->device().physical().getProperties();
-                    detail::logger->debug(
-                        "{} (vendor: {}, device: {}, {})",
-                        physical_device_property.deviceName,
-                        physical_device_property.deviceID,
-                        physical_device_property.vendorID,
-                        vk::to_string(physical_device_property.deviceType)
-                    );
-                    detail::logger->debug("selected queue family index {}", present_queue->family_index());
-                }
+        if (present_queue && detail::logger->level() <= spdlog::level::debug) {
+            detail::logger->debug("selected physical device:");
+            const auto& physical_device_property = core::device_capabilities(present_queue->device().physical()).properties;
+            detail::logger->debug(
+                "{} (vendor: {}, device: {}, {})",
+                physical_device_property.deviceName,
+                physical_device_property.deviceID,
+                physical_device_property.vendorID,
+                vk::to_string(physical_device_property.deviceType)
+            );
+            detail::logger->debug("selected queue family index {}", present_queue->family_index());
+        }
+    }
+
+    /**
+     *  @brief destroy the skia context and the device, in that order
+     */
+    void _release_device() {
+        if (skia_context) {
+            skia_context->releaseResourcesAndAbandonContext();
+            skia_context.reset();
+        }
+        detail::skia_persistent_cache.reset();
+        skia_vulkan_context.reset();
+        skia_vulkan_extensions.reset();
+        present_queue.reset();
+        prewarmed = false;
+    }
+}
+
+namespace tiara::wm {
+    /**
+     *  @brief write skia's VkPipelineCache to the on-disk cache, done at deinit and worth doing once the first frames are drawn
+     */
+    void store_skia_pipeline_cache() {
+        if (skia_context && detail::skia_persistent_cache) skia_context->storeVkPipelineCacheData();
+    }
+
+    /**
+     *  @brief wake the event loop if it is blocked in glfwWaitEvents, can be called from any thread
+     */
+    void wake_event_loop() {
+        glfwPostEmptyEvent();
+    }
+
+    std::optional<core::Queue> select_queue_for_surface(std::shared_ptr<vk::raii::PhysicalDevice> physical_device, vk::SurfaceKHR surface) {
+        auto& physical_device_ref = *physical_device;
+        return detail::_select_queue(
+            std::move(physical_device),
+            [&physical_device_ref, &surface](uint32_t queue_index, const vk::QueueFamilyProperties&) -> bool {
+                return physical_device_ref.getSurfaceSupportKHR(queue_index, surface);
+            }
+        );
+    }
+
+    /**
+     *  @brief select a graphics queue glfw reports as able to present, without a surface to check it against
+     */
+    std::optional<core::Queue> select_queue_for_presentation(std::shared_ptr<vk::raii::PhysicalDevice> physical_device) {
+        VkInstance instance = *core::context().vk_instance;
+        VkPhysicalDevice physical_device_handle = **physical_device;
+        return detail::_select_queue(
+            std::move(physical_device),
+            [instance, physical_device_handle](uint32_t queue_index, const vk::QueueFamilyProperties&) -> bool {
+                return glfwGetPhysicalDevicePresentationSupport(instance, physical_device_handle, queue_index) == GLFW_TRUE;
             }
-        } else {
+        );
+    }
+}
+
+namespace tiara::wm::detail {
+    /**
+     *  @brief select the device and create the skia context ahead of the first window, run on a thread of its own
+     */
+    void _prewarm() {
+        auto phase = core::detail::startup_report.time("device prewarm");
+        try {
+            _select_device_queue(
+                [](const core::DevicePropertiesPair&) {
+                    return true;
+                },
+                [](std::shared_ptr<vk::raii::PhysicalDevice> physical_device) {
+                    return select_queue_for_presentation(std::move(physical_device));
+                }
+            );
+            if (!present_queue) throw exceptions::DeviceQueueSelectionError{};
+            _setup_skia();
+            prewarmed = true;
+        } catch(...) {
+            _release_device();
+            throw;
+        }
+    }
+
+    void _start_prewarm() {
+        prewarm_result = std::async(std::launch::async, _prewarm);
+    }
+
+    /**
+     *  @brief wait for a prewarm started by WMExtension, a failed one leaves the device to the first window
+     */
+    void _wait_for_prewarm() {
+        if (!prewarm_result.valid()) return;
+        try {
+            prewarm_result.get();
+        } catch (const std::exception& e) {
+            detail::logger->warn("device prewarm failed, selecting on first window: {}", e.what());
+        }
+    }
+}
+
+namespace tiara::wm {
+    void select_device_queue_for_surface(vk::SurfaceKHR surface) {
+        detail::_wait_for_prewarm();
+        if (present_queue) {
             auto& physical_device = present_queue->device().physical();
             if (
+                !physical_device.getSurfaceSupportKHR(present_queue->family_index(), surface) ||
                 physical_device.getSurfaceFormatsKHR(surface).empty() || 
                 physical_device.getSurfacePresentModesKHR(surface).empty()
-            ) throw exceptions::DeviceQueueSelectionError{};
+            ) {
+                if (!detail::prewarmed) throw exceptions::DeviceQueueSelectionError{};
+                // glfw's answer without a surface does not hold for this one
+                detail::logger->warn("prewarmed device cannot present to surface, selecting again");
+                detail::_release_device();
+            }
+        }
+        if (!present_queue) {
+            detail::_select_device_queue(
+                [surface](const core::DevicePropertiesPair& physical_device_properties) {
+                    return !physical_device_properties.first.getSurfaceFormatsKHR(surface).empty() &&
+                        !physical_device_properties.first.getSurfacePresentModesKHR(surface).empty();
+                },
+                [surface](std::shared_ptr<vk::raii::PhysicalDevice> physical_device) {
+                    return select_queue_for_surface(std::move(physical_device), surface);
+                }
+            );
+            if (present_queue) detail::_setup_skia();
         }
         if (!present_queue) throw exceptions::DeviceQueueSelectionError{};
+        detail::prewarmed = false;
     }
 }
 
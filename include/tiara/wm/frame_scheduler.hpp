@@ -0,0 +1,159 @@
+#ifndef TIARA_WM_FRAME_SCHEDULER
+#define TIARA_WM_FRAME_SCHEDULER
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace tiara::wm {
+    enum class FramePacing {
+        // a single frame queued, started as late as the measured frame time allows so it samples the freshest input
+        low_latency,
+        // as many frames queued as the swapchain allows, drawn as soon as one can be
+        throughput,
+        // a single frame queued, no more often than the frame rate cap
+        power_saving
+    };
+
+    /**
+     *  @brief decides when a window starts its next frame and how deep its swapchain queue is, from its pacing mode,
+     *  the refresh rate of its monitor and the timing of the frames it presented
+     */
+    class FrameScheduler {
+        public:
+        using clock = std::chrono::steady_clock;
+
+        FramePacing mode() const noexcept {
+            return _mode;
+        }
+        void set_mode(FramePacing mode) noexcept {
+            _mode = mode;
+        }
+
+        clock::duration refresh_interval() const noexcept {
+            return _refresh_interval;
+        }
+        void set_refresh_rate(int hz) noexcept {
+            if (hz > 0) _refresh_interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / hz));
+        }
+
+        /**
+         *  @brief frame rate of power_saving, never above the refresh rate
+         */
+        void set_frame_rate_cap(double fps) noexcept {
+            if (fps > 0) _frame_rate_cap_interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / fps));
+        }
+        clock::duration frame_rate_cap_interval() const noexcept {
+            return _frame_rate_cap_interval;
+        }
+
+        /**
+         *  @brief measured time between presents, the refresh interval until enough frames were presented back to back
+         */
+        clock::duration present_interval() const noexcept {
+            return _present_interval_samples < 4 ? _refresh_interval : std::max(_present_interval, _refresh_interval);
+        }
+        /**
+         *  @brief measured time from the start of a frame to its present
+         */
+        clock::duration frame_time() const noexcept {
+            return _frame_time;
+        }
+
+        /**
+         *  @brief when the next frame should start, clock::time_point::min() if right away
+         */
+        clock::time_point next_frame_start() const noexcept {
+            if (!_last_present) return clock::time_point::min();
+            switch (_mode) {
+            case FramePacing::throughput:
+                return clock::time_point::min();
+            case FramePacing::low_latency: {
+                // start late enough to finish just before the next vblank after the last present
+                auto next_vblank = *_last_present + present_interval();
+                auto start = next_vblank - _frame_time - late_latch_margin;
+                return std::max(start, _last_start);
+            }
+            case FramePacing::power_saving:
+                return _last_start + std::max(_frame_rate_cap_interval, _refresh_interval);
+            }
+            return clock::time_point::min();
+        }
+
+        void frame_started(clock::time_point now) noexcept {
+            _last_start = now;
+        }
+        clock::time_point last_frame_start() const noexcept {
+            return _last_start;
+        }
+
+        void frame_presented(clock::time_point now) noexcept {
+            _frame_time = _average(_frame_time, now - _last_start, _frame_time_samples);
+            if (_last_present) {
+                auto interval = now - *_last_present;
+                // frames that were not drawn back to back say nothing about the display
+                if (interval < 4 * _refresh_interval) _present_interval = _average(_present_interval, interval, _present_interval_samples);
+            }
+            _last_present = now;
+        }
+
+        /**
+         *  @brief forget the measured timing, e.g. once the swapchain is recreated
+         */
+        void reset() noexcept {
+            _last_present.reset();
+            _frame_time = clock::duration::zero();
+            _frame_time_samples = 0;
+            _present_interval = clock::duration::zero();
+            _present_interval_samples = 0;
+        }
+
+        uint32_t swapchain_image_count(uint32_t min_image_count, uint32_t max_image_count) const noexcept {
+            // 0 is no maximum
+            if (max_image_count == 0) max_image_count = UINT32_MAX;
+            uint32_t count;
+            switch (_mode) {
+            case FramePacing::throughput:
+                count = min_image_count + 2;
+                break;
+            case FramePacing::power_saving:
+                count = min_image_count;
+                break;
+            default:
+                count = min_image_count + 1;
+                break;
+            }
+            // at least one image to draw while another is shown
+            return std::min(std::max(count, 2u), max_image_count);
+        }
+
+        std::size_t frames_in_flight(std::size_t image_count) const noexcept {
+            if (_mode == FramePacing::throughput) return std::max<std::size_t>(image_count - 1, 1);
+            return 1;
+        }
+
+        static constexpr clock::duration late_latch_margin = std::chrono::milliseconds{1};
+
+        private:
+        static clock::duration _average(clock::duration average, clock::duration sample, std::size_t& samples) noexcept {
+            // plain mean for the first few, then an exponential moving average weighting the newest by 1/8
+            samples++;
+            if (samples <= 8) return average + (sample - average) / static_cast<clock::rep>(samples);
+            return average + (sample - average) / 8;
+        }
+
+        FramePacing _mode = FramePacing::low_latency;
+        clock::duration _refresh_interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / 60));
+        clock::duration _frame_rate_cap_interval = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / 30));
+        clock::time_point _last_start;
+        std::optional<clock::time_point> _last_present;
+        clock::duration _frame_time = clock::duration::zero();
+        std::size_t _frame_time_samples = 0;
+        clock::duration _present_interval = clock::duration::zero();
+        std::size_t _present_interval_samples = 0;
+    };
+}
+
+#endif
@@ -4,6 +4,8 @@
 #include "tiara/core/stdincludes.hpp"
 
 #include "tiara/core/event/dispatcher.hpp"
+#include "tiara/core/event/event_queue.hpp"
+#include "tiara/core/event/routed_dispatcher.hpp"
 #include "tiara/core/vectors.hpp"
 #include "tiara/wm/common.hpp"
 
@@ -74,14 +76,10 @@ class MonitorEventDispatcher
                 }
                 switch (event) {
                 case GLFW_CONNECTED:
-                    for (auto h: _monitor_connected_handlers) {
-                        h.get().handle(events::MonitorConnectedEvent{{}, *_this}, core::event::sync_tag);
-                    }
+                    _dispatch(events::MonitorConnectedEvent{{}, *_this});
                     break;
                 case GLFW_DISCONNECTED:
-                    for (auto h: _monitor_disconnected_handlers) {
-                        h.get().handle(events::MonitorDisconnectedEvent{{}, *_this}, core::event::sync_tag);
-                    }
+                    _dispatch(events::MonitorDisconnectedEvent{{}, *_this});
                     delete _this;
                     break;
                 default:
@@ -109,22 +107,136 @@ class MonitorEventDispatcher
     }
 
     static void start_dispatch(core::event::Handler<events::MonitorConnectedEvent>& h) {
-        _monitor_connected_handlers.emplace_back(h);
+        _monitor_connected_handlers.subscribe(h);
     }
     static void stop_dispatch(core::event::Handler<events::MonitorConnectedEvent>& h) {
-        core::utils::remove_erase_if(_monitor_connected_handlers, [&h](const auto& ref_wrap) { return ref_wrap.get() == h; });
+        _monitor_connected_handlers.unsubscribe(h);
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        _monitor_connected_statistics.forget_handler(h);
+        #endif
     }
     static void start_dispatch(core::event::Handler<events::MonitorDisconnectedEvent>& h) {
-        _monitor_disconnected_handlers.emplace_back(h);
+        _monitor_disconnected_handlers.subscribe(h);
     }
     static void stop_dispatch(core::event::Handler<events::MonitorDisconnectedEvent>& h) {
-        core::utils::remove_erase_if(_monitor_disconnected_handlers, [&h](const auto& ref_wrap) { return ref_wrap.get() == h; });
+        _monitor_disconnected_handlers.unsubscribe(h);
+        _monitor_disconnected_routes.unsubscribe(h);
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        _monitor_disconnected_statistics.forget_handler(h);
+        #endif
     }
 
+    static core::event::Subscription<events::MonitorConnectedEvent> subscribe(core::event::Handler<events::MonitorConnectedEvent>& h) {
+        return _monitor_connected_handlers.subscribe(h);
+    }
+    static bool unsubscribe(core::event::Subscription<events::MonitorConnectedEvent> subscription) {
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        auto h = _monitor_connected_handlers.find(subscription);
+        if (!_monitor_connected_handlers.unsubscribe(subscription)) return false;
+        if (!_monitor_connected_handlers.is_subscribed(h)) _monitor_connected_statistics.forget_handler(*h);
+        return true;
+        #else
+        return _monitor_connected_handlers.unsubscribe(subscription);
+        #endif
+    }
+    static core::event::Subscription<events::MonitorDisconnectedEvent> subscribe(core::event::Handler<events::MonitorDisconnectedEvent>& h) {
+        return _monitor_disconnected_handlers.subscribe(h);
+    }
+    static bool unsubscribe(core::event::Subscription<events::MonitorDisconnectedEvent> subscription) {
+        return _monitor_disconnected_handlers.unsubscribe(subscription);
+    }
+
+    /**
+     *  @brief subscribe h to the disconnection of monitor only
+     */
+    static core::event::RoutedSubscription<events::MonitorDisconnectedEvent, const Monitor*> subscribe(core::event::Handler<events::MonitorDisconnectedEvent>& h, const Monitor& monitor) {
+        return _monitor_disconnected_routes.subscribe(h, &monitor);
+    }
+    template <core::utils::InvocableR<bool, const events::MonitorDisconnectedEvent&> Pred>
+    static core::event::RoutedSubscription<events::MonitorDisconnectedEvent, const Monitor*> subscribe(core::event::Handler<events::MonitorDisconnectedEvent>& h, const Monitor& monitor, Pred pred) {
+        return _monitor_disconnected_routes.subscribe(h, &monitor, std::move(pred));
+    }
+    static bool unsubscribe(const core::event::RoutedSubscription<events::MonitorDisconnectedEvent, const Monitor*>& subscription) {
+        return _monitor_disconnected_routes.unsubscribe(subscription);
+    }
+
+    /**
+     *  @brief post an event to be dispatched on the next dispatch_posted, can be called from any thread
+     */
+    template <typename Ev> requires std::same_as<Ev, events::MonitorConnectedEvent> || std::same_as<Ev, events::MonitorDisconnectedEvent>
+    static bool post(const Ev& event) {
+        if (!_posted_events.post(event)) return false;
+        wake_event_loop();
+        return true;
+    }
+
+    static std::size_t dispatch_posted() {
+        return _posted_events.drain([](const auto& event){ _dispatch(event); });
+    }
+
+    #if TIARA_ENABLE_EVENT_STATISTICS
+    template <typename Ev> requires std::same_as<Ev, events::MonitorConnectedEvent> || std::same_as<Ev, events::MonitorDisconnectedEvent>
+    static core::event::EventStatistics<Ev>& statistics() noexcept {
+        if constexpr (std::same_as<Ev, events::MonitorConnectedEvent>) return _monitor_connected_statistics;
+        else return _monitor_disconnected_statistics;
+    }
+
+    static std::vector<core::event::EventStatisticsSnapshot> statistics_snapshot() {
+        std::vector<core::event::EventStatisticsSnapshot> snapshots{_monitor_connected_statistics.snapshot(), _monitor_disconnected_statistics.snapshot()};
+        snapshots[0].subscribed_handlers = _monitor_connected_handlers.size();
+        snapshots[1].subscribed_handlers = _monitor_disconnected_handlers.size();
+        return snapshots;
+    }
+
+    static void reset_statistics() noexcept {
+        _monitor_connected_statistics.reset();
+        _monitor_disconnected_statistics.reset();
+    }
+    #endif
+
     private:
+    static void _dispatch(const events::MonitorConnectedEvent& event) {
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        _monitor_connected_statistics.record_dispatch();
+        #endif
+        _monitor_connected_handlers.for_each(
+            [&event](core::event::Handler<events::MonitorConnectedEvent>& h) {
+                #if TIARA_ENABLE_EVENT_STATISTICS
+                _monitor_connected_statistics.record_handler_call(h, [&h, &event]() { return h.handle(event, core::event::sync_tag); });
+                #else
+                h.handle(event, core::event::sync_tag);
+                #endif
+                return true;
+            }
+        );
+    }
+    static void _dispatch(const events::MonitorDisconnectedEvent& event) {
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        _monitor_disconnected_statistics.record_dispatch();
+        #endif
+        auto handle = [&event](core::event::Handler<events::MonitorDisconnectedEvent>& h) {
+            #if TIARA_ENABLE_EVENT_STATISTICS
+            _monitor_disconnected_statistics.record_handler_call(h, [&h, &event]() { return h.handle(event, core::event::sync_tag); });
+            #else
+            h.handle(event, core::event::sync_tag);
+            #endif
+            return true;
+        };
+        _monitor_disconnected_handlers.for_each(handle);
+        _monitor_disconnected_routes.for_each(&event.monitor, event, handle);
+        // the monitor is deleted after this, its address may be reused by a later one
+        _monitor_disconnected_routes.erase_route(&event.monitor);
+    }
+
     static inline bool _init = false;
-    static inline std::vector<std::reference_wrapper<core::event::Handler<events::MonitorConnectedEvent>>> _monitor_connected_handlers;
-    static inline std::vector<std::reference_wrapper<core::event::Handler<events::MonitorDisconnectedEvent>>> _monitor_disconnected_handlers;
+    static inline core::event::EventQueue<events::MonitorConnectedEvent, events::MonitorDisconnectedEvent> _posted_events;
+    static inline core::event::detail::HandlerList<events::MonitorConnectedEvent> _monitor_connected_handlers;
+    static inline core::event::detail::HandlerList<events::MonitorDisconnectedEvent> _monitor_disconnected_handlers;
+    static inline core::event::detail::RoutedHandlerTable<events::MonitorDisconnectedEvent, const Monitor*> _monitor_disconnected_routes;
+    #if TIARA_ENABLE_EVENT_STATISTICS
+    static inline core::event::EventStatistics<events::MonitorConnectedEvent> _monitor_connected_statistics;
+    static inline core::event::EventStatistics<events::MonitorDisconnectedEvent> _monitor_disconnected_statistics;
+    #endif
 };
 }
 
@@ -0,0 +1,123 @@
+#ifndef TIARA_WM_SKIA_CACHE
+#define TIARA_WM_SKIA_CACHE
+
+#include "tiara/core/stdincludes.hpp"
+
+#include "tiara/core/utilities/disk_cache.hpp"
+
+#include "skia/core/SkData.h"
+#include "skia/core/SkMilestone.h"
+#include "skia/gpu/GrContextOptions.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace tiara::wm::detail {
+    inline std::optional<std::filesystem::path> _default_cache_directory() {
+        #if BOOST_OS_WINDOWS
+        if (const char* local_app_data = std::getenv("LOCALAPPDATA")) return std::filesystem::path{local_app_data} / "tiara" / "cache";
+        #else
+        if (const char* xdg_cache_home = std::getenv("XDG_CACHE_HOME"); xdg_cache_home && *xdg_cache_home) return std::filesystem::path{xdg_cache_home} / "tiara";
+        if (const char* home = std::getenv("HOME")) return std::filesystem::path{home} / ".cache" / "tiara";
+        #endif
+        return std::nullopt;
+    }
+}
+
+namespace tiara::wm {
+    /**
+     *  @brief root of the on-disk shader and pipeline cache, no cache is used if empty
+     */
+    static inline std::optional<std::filesystem::path> skia_cache_directory = detail::_default_cache_directory();
+    /**
+     *  @brief size cap of the cache of a single device and driver
+     */
+    static inline std::uintmax_t skia_cache_max_bytes = 64 * 1024 * 1024;
+}
+
+namespace tiara::wm::detail {
+    /**
+     *  @brief directory of the cache for a device, a different driver, pipeline cache uuid or skia milestone gets a fresh one
+     */
+    inline std::filesystem::path _skia_cache_directory_for(const std::filesystem::path& root, const vk::PhysicalDeviceProperties& properties) {
+        char device_name[32];
+        std::snprintf(device_name, sizeof(device_name), "%08x-%08x", properties.vendorID, properties.deviceID);
+        char driver_name[32];
+        std::snprintf(driver_name, sizeof(driver_name), "%08x-m%d-", properties.driverVersion, SK_MILESTONE);
+        std::string driver_key{driver_name};
+        for (uint8_t byte: properties.pipelineCacheUUID) {
+            char digits[3];
+            std::snprintf(digits, sizeof(digits), "%02x", byte);
+            driver_key += digits;
+        }
+        return root / "skia" / device_name / driver_key;
+    }
+
+    /**
+     *  @brief remove the caches of other driver versions of the same device, they cannot be used again once the driver was updated
+     *
+     *  caches of the same driver for other skia milestones are kept, another program on this machine may still use them.
+     */
+    inline void _remove_stale_skia_caches(const std::filesystem::path& directory) {
+        // the driver version is the leading 8 hex digits of the name made by _skia_cache_directory_for
+        constexpr std::size_t driver_version_length = 8;
+        std::string driver_version = directory.filename().string().substr(0, driver_version_length);
+        std::error_code error;
+        for (auto& entry: std::filesystem::directory_iterator{directory.parent_path(), error}) {
+            if (entry.path().filename().string().substr(0, driver_version_length) != driver_version) std::filesystem::remove_all(entry.path(), error);
+        }
+    }
+
+    /**
+     *  @brief skia persistent cache backed by a DiskCache, also receives skia's VkPipelineCache on storeVkPipelineCacheData
+     */
+    class SkiaPersistentCache: public GrContextOptions::PersistentCache {
+        public:
+        SkiaPersistentCache(std::filesystem::path directory, std::uintmax_t max_bytes): _cache{std::move(directory), max_bytes} {}
+
+        sk_sp<SkData> load(const SkData& key) override {
+            auto data = _cache.load(_bytes_of(key));
+            if (!data) {
+                _misses++;
+                return nullptr;
+            }
+            _hits++;
+            return SkData::MakeWithCopy(data->data(), data->size());
+        }
+
+        void store(const SkData& key, const SkData& data) override {
+            _cache.store(_bytes_of(key), _bytes_of(data));
+        }
+
+        const core::utils::DiskCache& cache() const noexcept {
+            return _cache;
+        }
+
+        std::size_t hits() const noexcept {
+            return _hits;
+        }
+        std::size_t misses() const noexcept {
+            return _misses;
+        }
+
+        private:
+        static std::span<const std::byte> _bytes_of(const SkData& data) noexcept {
+            return {static_cast<const std::byte*>(data.data()), data.size()};
+        }
+
+        core::utils::DiskCache _cache;
+        // skia calls the cache from the thread owning the context only
+        std::size_t _hits = 0;
+        std::size_t _misses = 0;
+    };
+
+    static inline std::unique_ptr<SkiaPersistentCache> skia_persistent_cache;
+}
+
+#endif
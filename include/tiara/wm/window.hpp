@@ -5,17 +5,27 @@
 
 #include "tiara/common/events/draw.hpp"
 #include "tiara/core/core.hpp"
+#include "tiara/core/event/coalesce.hpp"
 #include "tiara/core/event/dispatcher.hpp"
+#include "tiara/core/event/event_queue.hpp"
+#include "tiara/core/event/record.hpp"
 #include "tiara/core/vectors.hpp"
 #include "tiara/wm/common.hpp"
+#include "tiara/wm/frame_scheduler.hpp"
 
+#include "skia/core/SkRegion.h"
 #include "skia/core/SkSurface.h"
 #include "skia/gpu/GrBackendSemaphore.h"
 
 #include <algorithm>
-#include <map>
+#include <chrono>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <stdexcept>
+#include <tuple>
 #include <vector>
 
 namespace tiara::wm::events {
@@ -83,7 +93,6 @@ namespace tiara::wm {
 }
 
 namespace tiara::wm::detail {
-    static inline std::map<void*, std::vector<std::pair<vk::raii::Semaphore, GrBackendSemaphore>>> _undeleted_semaphores;
 class Window: 
     public core::event::DefaultDispatcher<
         events::WindowPosEvent, 
@@ -111,6 +120,50 @@ class Window:
         events::WindowScaleEvent,
         common::events::DrawEvent
     >;
+    using PostedEventQueueT = core::event::EventQueue<
+        events::WindowPosEvent, 
+        events::WindowSizeEvent,
+        events::WindowCloseEvent,
+        events::WindowRefreshEvent,
+        events::WindowFocusEvent,
+        events::WindowMinimizeEvent,
+        events::WindowMaximizeEvent,
+        events::WindowFramebufferSizeEvent,
+        events::WindowScaleEvent
+    >;
+    using EventRecorderT = core::event::EventRecorder<
+        events::WindowPosEvent, 
+        events::WindowSizeEvent,
+        events::WindowCloseEvent,
+        events::WindowRefreshEvent,
+        events::WindowFocusEvent,
+        events::WindowMinimizeEvent,
+        events::WindowMaximizeEvent,
+        events::WindowFramebufferSizeEvent,
+        events::WindowScaleEvent
+    >;
+    using EventReplayerT = core::event::EventReplayer<
+        events::WindowPosEvent, 
+        events::WindowSizeEvent,
+        events::WindowCloseEvent,
+        events::WindowRefreshEvent,
+        events::WindowFocusEvent,
+        events::WindowMinimizeEvent,
+        events::WindowMaximizeEvent,
+        events::WindowFramebufferSizeEvent,
+        events::WindowScaleEvent
+    >;
+    using CoalescingBuffersT = std::tuple<
+        core::event::CoalescingBuffer<events::WindowPosEvent>,
+        core::event::CoalescingBuffer<events::WindowSizeEvent>,
+        core::event::CoalescingBuffer<events::WindowCloseEvent>,
+        core::event::CoalescingBuffer<events::WindowRefreshEvent>,
+        core::event::CoalescingBuffer<events::WindowFocusEvent>,
+        core::event::CoalescingBuffer<events::WindowMinimizeEvent>,
+        core::event::CoalescingBuffer<events::WindowMaximizeEvent>,
+        core::event::CoalescingBuffer<events::WindowFramebufferSizeEvent>,
+        core::event::CoalescingBuffer<events::WindowScaleEvent>
+    >;
 
     Window(
         core::iVec2D size,
@@ -123,34 +176,8 @@ class Window:
 
     virtual ~Window() {
         detail::logger->info("destroying window: {}", static_cast<void*>(_window_raw));
-        if (_run || current_frames_enqueued > 0) {
-            auto [it, success] = _undeleted_semaphores.emplace(static_cast<void*>(this), std::vector<std::pair<vk::raii::Semaphore, GrBackendSemaphore>>{});
-            if (!success) {
-                detail::logger->warn("window {}: window might not get stopped properly", static_cast<void*>(_window_raw));
-                detail::logger->debug("window {}: (run: {}, frames_enqueued: {})", static_cast<void*>(_window_raw), _run, current_frames_enqueued);
-            } else {
-                it->second.reserve(
-                    _window_swapchain_image_renderable_semaphores.size() +
-                    _window_swapchain_image_rendered_semaphores.size() +
-                    _window_swapchain_image_presentable_semaphores.size()
-                );
-                it->second.insert(
-                    it->second.end(),
-                    std::make_move_iterator(_window_swapchain_image_renderable_semaphores.begin()),
-                    std::make_move_iterator(_window_swapchain_image_renderable_semaphores.end())
-                );
-                it->second.insert(
-                    it->second.end(),
-                    std::make_move_iterator(_window_swapchain_image_rendered_semaphores.begin()),
-                    std::make_move_iterator(_window_swapchain_image_rendered_semaphores.end())
-                );
-                it->second.insert(
-                    it->second.end(),
-                    std::make_move_iterator(_window_swapchain_image_presentable_semaphores.begin()),
-                    std::make_move_iterator(_window_swapchain_image_presentable_semaphores.end())
-                );
-            }
-        }
+        // the semaphores of frames still in flight are destroyed along with the window
+        _retire_frames(true);
         _unregister_glfw_callbacks();
         glfwDestroyWindow(_window_raw);
         detail::logger->info("destroyed window: {}", static_cast<void*>(_window_raw));
@@ -165,64 +192,155 @@ class Window:
 
     using DefaultDispatcherT::start_dispatch;
     using DefaultDispatcherT::stop_dispatch;
+    using DefaultDispatcherT::subscribe;
+    using DefaultDispatcherT::unsubscribe;
 
     void start_dispatch(core::event::Handler<common::events::DrawEvent>& h) final {
         _window_draw_handler.emplace(h);
     }
     void stop_dispatch(core::event::Handler<common::events::DrawEvent>& h) final {
-        if (_window_draw_handler && _window_draw_handler.value().get() == h) _window_draw_handler.reset();
+        if (_window_draw_handler && _window_draw_handler.value().get() == h) {
+            _window_draw_handler.reset();
+            #if TIARA_ENABLE_EVENT_STATISTICS
+            DefaultDispatcherT::statistics<common::events::DrawEvent>().forget_handler(h);
+            #endif
+        }
+    }
+    // a window has a single draw handler, set it with start_dispatch
+    core::event::Subscription<common::events::DrawEvent> subscribe(core::event::Handler<common::events::DrawEvent>& h) = delete;
+
+    /**
+     *  @brief post an event to be dispatched on the thread calling draw, can be called from any thread
+     */
+    template <std::derived_from<core::event::Event> Ev>
+    bool post(const Ev& event) {
+        if (!_posted_events.post(event)) return false;
+        wake_event_loop();
+        return true;
+    }
+
+    std::size_t dispatch_posted() {
+        return _posted_events.drain(
+            [this](const auto& event) {
+                DefaultDispatcherT::dispatch(event, core::event::reducers::any_of{});
+            }
+        );
+    }
+
+    /**
+     *  @brief buffer events of type Ev from glfw callbacks according to policy, to be dispatched once per frame
+     *
+     *  buffered events are dispatched one at a time in arrival order, each stopping at the first handler consuming it.
+     */
+    template <std::derived_from<core::event::Event> Ev>
+    void set_coalesce_policy(core::event::CoalescePolicy policy) {
+        std::get<core::event::CoalescingBuffer<Ev>>(_coalesced_events).set_policy(policy);
     }
 
+    std::size_t dispatch_coalesced() {
+        return std::apply(
+            [this](auto&... buffers) {
+                return (
+                    buffers.flush(
+                        [this](const auto& event) {
+                            DefaultDispatcherT::dispatch(event, core::event::reducers::any_of{});
+                        }
+                    ) + ...
+                );
+            },
+            _coalesced_events
+        );
+    }
+
+    /**
+     *  @brief record every event arriving from glfw callbacks to recorder, before coalescing
+     */
+    void start_recording(std::shared_ptr<EventRecorderT> recorder) {
+        _recorder = std::move(recorder);
+    }
+    void stop_recording() {
+        _recorder.reset();
+    }
+
+    /**
+     *  @brief feed a recorded event through the same path as glfw callbacks
+     */
+    template <std::derived_from<core::event::Event> Ev>
+    void replay(const Ev& event) {
+        _dispatch_window_event(event);
+    }
+
+    /**
+     *  @brief draw and present a frame, blocking only while every frame in flight is still on the gpu
+     *
+     *  rendering and the transition to present layout go to the gpu in a single submission, so the cpu records the
+     *  next frame while the gpu works on up to max_frames_enqueued earlier ones.
+     */
     void draw() {
-        if (current_frames_enqueued >= max_frames_enqueued) return;
+        dispatch_posted();
+        dispatch_coalesced();
         if (!_window_draw_handler || !_run) return;
+        _retire_frames(false);
+        if (_throttled(FrameScheduler::clock::now())) return;
+        if (_swapchain_outdated) _recreate_swapchain();
+        if (!_damage_tracking) invalidate();
+        // nothing changed since the last present, the image on screen is still right, events went out above regardless
+        if (_pending_damage.isEmpty()) return;
         if (current_image == std::numeric_limits<uint32_t>::max()) {
-            auto [result, next_image] = _window_swapchain.acquireNextImage(0, *(_window_swapchain_image_renderable_semaphores.back().first));
+            _wait_for_frame_slot();
+            vk::Result result;
+            uint32_t next_image;
+            try {
+                std::tie(result, next_image) = _window_swapchain.acquireNextImage(std::numeric_limits<uint64_t>::max(), *(_window_swapchain_image_renderable_semaphores.back().first));
+            } catch (const vk::OutOfDateKHRError&) {
+                _recreate_swapchain();
+                return;
+            }
             if (result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR) {
                 current_image = next_image;
                 std::swap(_window_swapchain_image_renderable_semaphores[current_image], _window_swapchain_image_renderable_semaphores.back());
             }
             else return;
         }
-        while (!_window_skia_surfaces[current_image]->wait(1, &_window_swapchain_image_renderable_semaphores[current_image].second, false));
-        _window_draw_handler->get().handle(common::events::DrawEvent{{}, _window_skia_surfaces[current_image]->getCanvas()}, core::event::sync_tag);
-        if (
-            skia_context->flush(
-                GrFlushInfo {
-                    .fNumSemaphores = 1,
-                    .fSignalSemaphores = &_window_swapchain_image_rendered_semaphores[current_image].second
-                }
-            ) == GrSemaphoresSubmitted::kNo
-        ) {
-            detail::logger->error("window {}: skia cannot flush semaphores to submit", static_cast<void*>(_window_raw));
-            // throw exceptions::DrawWindowError{"skia cannot flush semaphores to submit"};
-        }
-        if (!skia_context->submit()) {
-            detail::logger->error("window {}: skia cannot submit semaphores to queue", static_cast<void*>(_window_raw));
-            // throw exceptions::DrawWindowError{"skia cannot submit semaphores to queue"};
-        }
-        while (!_window_skia_surfaces[current_image]->wait(1, &_window_swapchain_image_rendered_semaphores[current_image].second, false));
-        if (
-            !skia_context->setBackendRenderTargetState(
-                _window_skia_backend_render_targets[current_image],
-                {static_cast<VkImageLayout>(vk::ImageLayout::ePresentSrcKHR), VK_QUEUE_FAMILY_IGNORED}
-            )
-        ) {
-            detail::logger->error("window {}: skia cannot transition image to present source", static_cast<void*>(_window_raw));
+        _frame_scheduler.frame_started(FrameScheduler::clock::now());
+        // every image has to catch up on the damage, the one drawn now also on what it missed while others were shown
+        for (auto& image_damage: _window_swapchain_image_damage) image_damage.op(_pending_damage, SkRegion::kUnion_Op);
+        SkRegion present_damage;
+        present_damage.swap(_pending_damage);
+        SkRegion& damage = _window_swapchain_image_damage[current_image];
+        auto& skia_surface = _window_skia_surfaces[current_image];
+        // queued on the gpu ahead of the commands of this frame, does not block
+        if (!skia_surface->wait(1, &_window_swapchain_image_renderable_semaphores[current_image].second, false)) {
+            detail::logger->error("window {}: skia cannot wait on image acquisition", static_cast<void*>(_window_raw));
         }
+        SkCanvas* canvas = skia_surface->getCanvas();
+        bool full_damage = damage.isRect() && damage.getBounds().contains(SkIRect::MakeWH(_window_swapchain_extent.x, _window_swapchain_extent.y));
+        canvas->save();
+        if (!full_damage) canvas->clipRegion(damage);
+        common::events::DrawEvent draw_event{{}, canvas, full_damage ? nullptr : &damage, &_pending_damage};
+        #if TIARA_ENABLE_EVENT_STATISTICS
+        auto& draw_statistics = DefaultDispatcherT::statistics<common::events::DrawEvent>();
+        draw_statistics.record_dispatch();
+        draw_statistics.record_handler_call(
+            _window_draw_handler->get(),
+            [this, &draw_event]() {
+                return _window_draw_handler->get().handle(draw_event, core::event::sync_tag);
+            }
+        );
+        #else
+        _window_draw_handler->get().handle(draw_event, core::event::sync_tag);
+        #endif
+        canvas->restore();
+        damage.setEmpty();
         if (
-            skia_context->flush(
+            skia_surface->flush(
+                SkSurface::BackendSurfaceAccess::kPresent,
                 GrFlushInfo {
                     .fNumSemaphores = 1,
-                    .fSignalSemaphores = &_window_swapchain_image_presentable_semaphores[current_image].second,
-                    .fFinishedProc = [](GrGpuFinishedContext finish_context){
-                        _undeleted_semaphores.erase(finish_context);
-                    },
-                    .fFinishedContext = this
+                    .fSignalSemaphores = &_window_swapchain_image_presentable_semaphores[current_image].second
                 }
             ) == GrSemaphoresSubmitted::kNo
         ) {
-            current_frames_enqueued++;
             detail::logger->error("window {}: skia cannot flush semaphores to submit", static_cast<void*>(_window_raw));
             // throw exceptions::DrawWindowError{"skia cannot flush semaphores to submit"};
         }
@@ -230,8 +348,32 @@ class Window:
             detail::logger->error("window {}: skia cannot submit semaphores to queue", static_cast<void*>(_window_raw));
             // throw exceptions::DrawWindowError{"skia cannot submit semaphores to queue"};
         }
+        // an empty submission signals its fence once everything submitted before it is done, skia keeps its own fences to itself
+        auto& frame_fence = _frame_fences[_frame_slot];
+        present_queue.value()->submit(nullptr, *frame_fence.first);
+        frame_fence.second = true;
+        _frame_slot = (_frame_slot + 1) % _frame_fences.size();
         current_frames_enqueued++;
+        // only what changed since the last present, the presentation engine keeps the rest
+        auto& present_rects = _present_rects;
+        present_rects.clear();
+        vk::PresentRegionKHR present_region;
+        vk::PresentRegionsKHR present_regions;
+        if (_incremental_present && !present_damage.getBounds().contains(SkIRect::MakeWH(_window_swapchain_extent.x, _window_swapchain_extent.y))) {
+            for (SkRegion::Iterator it{present_damage}; !it.done(); it.next()) {
+                const SkIRect& rect = it.rect();
+                present_rects.push_back({
+                    .offset = {rect.x(), rect.y()},
+                    .extent = {static_cast<uint32_t>(rect.width()), static_cast<uint32_t>(rect.height())}
+                });
+            }
+        }
+        if (!present_rects.empty()) {
+            present_region = {.rectangleCount = static_cast<uint32_t>(present_rects.size()), .pRectangles = present_rects.data()};
+            present_regions = {.swapchainCount = 1, .pRegions = &present_region};
+        }
         auto result = present_queue.value()->presentKHR({
+            .pNext = present_rects.empty() ? nullptr : &present_regions,
             .waitSemaphoreCount = 1,
             .pWaitSemaphores = &(*_window_swapchain_image_presentable_semaphores[current_image].first),
             .swapchainCount = 1,
@@ -239,6 +381,11 @@ class Window:
             .pImageIndices = &current_image
         });
         current_image = std::numeric_limits<uint32_t>::max();
+        _frame_scheduler.frame_presented(FrameScheduler::clock::now());
+        if (!_first_frame_presented && (result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR)) {
+            _first_frame_presented = true;
+            core::detail::startup_report.mark_once("first frame presented");
+        }
         if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR) {
             _recreate_swapchain();
         } else if (result != vk::Result::eSuccess) {
@@ -249,53 +396,154 @@ class Window:
     void stop() {
         _run = false;
     }
+    bool running() const noexcept {
+        return _run;
+    }
+
+    /**
+     *  @brief show or hide the window, a hidden window draws no frames but still has its events delivered
+     */
+    void show() {
+        glfwShowWindow(_window_raw);
+        _visible = true;
+    }
+    void hide() {
+        glfwHideWindow(_window_raw);
+        _visible = false;
+    }
+
+    bool focused() const noexcept {
+        return _focused;
+    }
+    bool minimized() const noexcept {
+        return _minimized;
+    }
+
+    /**
+     *  @brief cap the frame rate while the window is not focused, no cap if nullopt, the default
+     *
+     *  like being minimized or hidden, this only holds back drawing, events are delivered as they arrive.
+     */
+    void set_unfocused_frame_rate(std::optional<double> fps) {
+        if (fps && *fps > 0) _unfocused_frame_interval = std::chrono::duration_cast<FrameScheduler::clock::duration>(std::chrono::duration<double>(1.0 / *fps));
+        else _unfocused_frame_interval.reset();
+    }
+
+    /**
+     *  @brief mark rect as changed, it is redrawn on the next draw
+     */
+    void invalidate(const SkIRect& rect) {
+        SkIRect clipped = rect;
+        if (clipped.intersect(SkIRect::MakeWH(_window_swapchain_extent.x, _window_swapchain_extent.y))) _pending_damage.op(clipped, SkRegion::kUnion_Op);
+    }
+    void invalidate() {
+        _pending_damage.setRect(SkIRect::MakeWH(_window_swapchain_extent.x, _window_swapchain_extent.y));
+    }
+
+    /**
+     *  @brief only redraw what was invalidated, clipping the canvas to it, and skip frames where nothing was
+     *
+     *  off by default, every draw then redraws the whole window. a window skipping frames still has its events delivered.
+     */
+    void set_damage_tracking(bool enabled) {
+        _damage_tracking = enabled;
+    }
+    bool damage_tracking() const noexcept {
+        return _damage_tracking;
+    }
+
+    /**
+     *  @brief switch pacing mode, the swapchain is recreated with the present mode and image count of mode on the next draw
+     */
+    void set_frame_pacing(FramePacing mode) {
+        if (mode == _frame_scheduler.mode()) return;
+        _frame_scheduler.set_mode(mode);
+        _swapchain_outdated = true;
+    }
+    FrameScheduler& frame_scheduler() noexcept {
+        return _frame_scheduler;
+    }
+
+    /**
+     *  @brief when the frame scheduler wants the next frame drawn, never if there is nothing to draw
+     *
+     *  only drawing waits for it, wm::run delivers events on every wakeup and draw delivers them before deciding to skip.
+     */
+    FrameScheduler::clock::time_point next_frame_start() const noexcept {
+        if (!_window_draw_handler || !_run) return FrameScheduler::clock::time_point::max();
+        if (!_presentable()) return FrameScheduler::clock::time_point::max();
+        if (_damage_tracking && _pending_damage.isEmpty()) return FrameScheduler::clock::time_point::max();
+        if (!_focused && _unfocused_frame_interval) return std::max(_frame_scheduler.next_frame_start(), _frame_scheduler.last_frame_start() + *_unfocused_frame_interval);
+        return _frame_scheduler.next_frame_start();
+    }
     private:
     std::optional<std::reference_wrapper<core::event::Handler<common::events::DrawEvent>>> _window_draw_handler;
+    PostedEventQueueT _posted_events;
+    CoalescingBuffersT _coalesced_events;
+    std::shared_ptr<EventRecorderT> _recorder;
+
+    template <std::derived_from<core::event::Event> Ev>
+    void _dispatch_window_event(const Ev& event) {
+        if (_recorder) _recorder->record(event);
+        if (std::get<core::event::CoalescingBuffer<Ev>>(_coalesced_events).push(event)) return;
+        DefaultDispatcherT::dispatch(event, core::event::reducers::any_of{});
+    }
 
     static void _glfw_window_pos_callback(GLFWwindow* _window_raw_cb, int xpos, int ypos) {
         Window* _this = static_cast<Window*>(glfwGetWindowUserPointer(_window_raw_cb));
         if (_this == NULL) return;
-        _this->DefaultDispatcherT::dispatch(events::WindowPosEvent{{xpos, ypos}}, 0);
+        _this->_update_refresh_rate();
+        _this->_dispatch_window_event(events::WindowPosEvent{{xpos, ypos}});
     }
     static void _glfw_window_size_callback(GLFWwindow* _window_raw_cb, int width, int height) { 
         Window* _this = static_cast<Window*>(glfwGetWindowUserPointer(_window_raw_cb));
         if (_this == NULL) return;
-        _this->DefaultDispatcherT::dispatch(events::WindowSizeEvent{{width, height}}, 0);
+        _this->_dispatch_window_event(events::WindowSizeEvent{{width, height}});
     }
     static void _glfw_window_close_callback(GLFWwindow* _window_raw_cb) {
         Window* _this = static_cast<Window*>(glfwGetWindowUserPointer(_window_raw_cb));
         if (_this == NULL) return;
-        _this->DefaultDispatcherT::dispatch(events::WindowCloseEvent{}, 0);
+        _this->_dispatch_window_event(events::WindowCloseEvent{});
     }
     static void _glfw_window_refresh_callback(GLFWwindow* _window_raw_cb) {
         Window* _this = static_cast<Window*>(glfwGetWindowUserPointer(_window_raw_cb));
         if (_this == NULL) return;
-        _this->DefaultDispatcherT::dispatch(events::WindowRefreshEvent{}, 0);
+        // the window system lost the contents
+        _this->invalidate();
+        _this->_dispatch_window_event(events::WindowRefreshEvent{});
     }
     static void _glfw_window_focus_callback(GLFWwindow* _window_raw_cb, int focused) {
         Window* _this = static_cast<Window*>(glfwGetWindowUserPointer(_window_raw_cb));
         if (_this == NULL) return;
-        _this->DefaultDispatcherT::dispatch(events::WindowFocusEvent{}, 0);
+        _this->_focused = focused == GLFW_TRUE;
+        _this->_dispatch_window_event(events::WindowFocusEvent{{}, focused == GLFW_TRUE});
     }
     static void _glfw_window_iconify_callback(GLFWwindow* _window_raw_cb, int iconified) {
         Window* _this = static_cast<Window*>(glfwGetWindowUserPointer(_window_raw_cb));
         if (_this == NULL) return;
-        _this->DefaultDispatcherT::dispatch(events::WindowMinimizeEvent{}, 0);
+        _this->_minimized = iconified == GLFW_TRUE;
+        _this->_dispatch_window_event(events::WindowMinimizeEvent{{}, iconified == GLFW_TRUE});
     }
     static void _glfw_window_maximize_callback(GLFWwindow* _window_raw_cb, int maximized) {
         Window* _this = static_cast<Window*>(glfwGetWindowUserPointer(_window_raw_cb));
         if (_this == NULL) return;
-        _this->DefaultDispatcherT::dispatch(events::WindowMaximizeEvent{}, 0);
+        _this->_dispatch_window_event(events::WindowMaximizeEvent{{}, maximized == GLFW_TRUE});
     }
     static void _glfw_window_framebuffer_size_callback(GLFWwindow* _window_raw_cb, int width, int height) {
         Window* _this = static_cast<Window*>(glfwGetWindowUserPointer(_window_raw_cb));
         if (_this == NULL) return;
-        _this->DefaultDispatcherT::dispatch(events::WindowFramebufferSizeEvent{width, height}, 0);
+        _this->_framebuffer_size = {width, height};
+        // not every platform reports the old swapchain as out of date
+        if (
+            width > 0 && height > 0 &&
+            (width != _this->_window_swapchain_extent.x || height != _this->_window_swapchain_extent.y)
+        ) _this->_swapchain_outdated = true;
+        _this->_dispatch_window_event(events::WindowFramebufferSizeEvent{width, height});
     }
     static void _glfw_window_content_scale_callback(GLFWwindow* _window_raw_cb, float xscale, float yscale) {
         Window* _this = static_cast<Window*>(glfwGetWindowUserPointer(_window_raw_cb));
         if (_this == NULL) return;
-        _this->DefaultDispatcherT::dispatch(events::WindowScaleEvent{xscale, yscale}, 0);
+        _this->_dispatch_window_event(events::WindowScaleEvent{xscale, yscale});
     }
 
     void _register_glfw_callbacks() {
@@ -323,14 +571,91 @@ class Window:
         glfwSetWindowContentScaleCallback(_window_raw, NULL);
     }
 
+    bool _presentable() const noexcept {
+        // nothing would be seen, and the swapchain may not even be valid for a zero sized framebuffer
+        return _visible && !_minimized && _framebuffer_size.x > 0 && _framebuffer_size.y > 0;
+    }
+
+    /**
+     *  @brief whether acquiring and presenting an image is held back at now, events are delivered regardless
+     */
+    bool _throttled(FrameScheduler::clock::time_point now) const noexcept {
+        if (!_presentable()) return true;
+        return !_focused && _unfocused_frame_interval && now < _frame_scheduler.last_frame_start() + *_unfocused_frame_interval;
+    }
+
+    /**
+     *  @brief take the refresh rate of the monitor the window is on, the one of its center for windowed windows
+     */
+    void _update_refresh_rate() {
+        GLFWmonitor* monitor = glfwGetWindowMonitor(_window_raw);
+        if (!monitor) {
+            int x, y, w, h;
+            glfwGetWindowPos(_window_raw, &x, &y);
+            glfwGetWindowSize(_window_raw, &w, &h);
+            int center_x = x + w / 2, center_y = y + h / 2;
+            int monitor_count;
+            GLFWmonitor** monitors = glfwGetMonitors(&monitor_count);
+            for (int i = 0; i < monitor_count; i++) {
+                int monitor_x, monitor_y;
+                glfwGetMonitorPos(monitors[i], &monitor_x, &monitor_y);
+                const GLFWvidmode* mode = glfwGetVideoMode(monitors[i]);
+                if (
+                    mode &&
+                    center_x >= monitor_x && center_x < monitor_x + mode->width &&
+                    center_y >= monitor_y && center_y < monitor_y + mode->height
+                ) {
+                    monitor = monitors[i];
+                    break;
+                }
+            }
+            if (!monitor) monitor = glfwGetPrimaryMonitor();
+        }
+        if (!monitor) return;
+        if (const GLFWvidmode* mode = glfwGetVideoMode(monitor)) _frame_scheduler.set_refresh_rate(mode->refreshRate);
+    }
+
+    /**
+     *  @brief forget the frames the gpu is done with, waiting for all of them if wait_all
+     */
+    void _retire_frames(bool wait_all) {
+        if (current_frames_enqueued == 0 || !present_queue) return;
+        auto& device = present_queue->device();
+        for (auto& [fence, pending]: _frame_fences) {
+            if (!pending) continue;
+            if (device->waitForFences(*fence, true, wait_all ? std::numeric_limits<uint64_t>::max() : 0) != vk::Result::eSuccess) continue;
+            device->resetFences(*fence);
+            pending = false;
+            current_frames_enqueued--;
+        }
+        // lets skia run finished procs and reuse the command buffers of those frames
+        if (skia_context) skia_context->checkAsyncWorkCompletion();
+    }
+
+    /**
+     *  @brief block until the fence of the next frame is free, the frame using it last is then max_frames_enqueued frames old
+     */
+    void _wait_for_frame_slot() {
+        auto& [fence, pending] = _frame_fences[_frame_slot];
+        if (!pending) return;
+        auto& device = present_queue->device();
+        static_cast<void>(device->waitForFences(*fence, true, std::numeric_limits<uint64_t>::max()));
+        device->resetFences(*fence);
+        pending = false;
+        current_frames_enqueued--;
+        skia_context->checkAsyncWorkCompletion();
+    }
+
     void _recreate_swapchain() {
+        auto first_creation_phase = core::detail::startup_report.time_once("first swapchain creation");
         auto& device = present_queue->device();
         device->waitIdle();
+        _retire_frames(true);
+        _swapchain_outdated = false;
+        _update_refresh_rate();
+        _frame_scheduler.reset();
         auto surface_capabilities = device.physical().getSurfaceCapabilitiesKHR(*_window_surface);
-        uint32_t swapchain_image_count = std::min(
-            surface_capabilities.minImageCount + 1,
-            surface_capabilities.maxImageCount == 0 ? std::numeric_limits<uint32_t>::max() : surface_capabilities.maxImageCount
-        );
+        uint32_t swapchain_image_count = _frame_scheduler.swapchain_image_count(surface_capabilities.minImageCount, surface_capabilities.maxImageCount);
         detail::logger->debug(
             "window {}: selecting swapchain minimum image count {} (min: {}, max {})",
             static_cast<void*>(_window_raw),
@@ -370,6 +695,7 @@ class Window:
 
         int width, height;
         glfwGetFramebufferSize(_window_raw, &width, &height);
+        _framebuffer_size = {width, height};
 
         vk::Extent2D swapchain_image_extent {
             .width = std::clamp(static_cast<uint32_t>(width), surface_capabilities.minImageExtent.width, surface_capabilities.maxImageExtent.width),
@@ -387,12 +713,14 @@ class Window:
             surface_capabilities.maxImageExtent.height
         );
         
-        auto available_surface_present_modes = device.physical().getSurfacePresentModesKHR(*_window_surface);
-        auto surface_present_mode_it = std::ranges::find(
-            available_surface_present_modes, 
-            vk::PresentModeKHR::eMailbox
-        );
-        auto swapchain_image_present_mode = (surface_present_mode_it == available_surface_present_modes.end() ? vk::PresentModeKHR::eFifo : *surface_present_mode_it);
+        // fifo is always available, and queues every frame for throughput and power saving
+        auto swapchain_image_present_mode = vk::PresentModeKHR::eFifo;
+        if (_frame_scheduler.mode() == FramePacing::low_latency) {
+            auto available_surface_present_modes = device.physical().getSurfacePresentModesKHR(*_window_surface);
+            if (std::ranges::find(available_surface_present_modes, vk::PresentModeKHR::eMailbox) != available_surface_present_modes.end()) {
+                swapchain_image_present_mode = vk::PresentModeKHR::eMailbox;
+            }
+        }
         detail::logger->debug(
             "window {}: selecting swapchain image present mode {}",
             static_cast<void*>(_window_raw),
@@ -502,27 +830,6 @@ class Window:
             );
             detail::logger->debug("window {}: created image renderable semaphores ({})", static_cast<void*>(_window_raw), _window_swapchain_image_renderable_semaphores.size());
         }
-        size_t swapchain_image_rendered_semaphores_size = _window_swapchain_image_rendered_semaphores.size();
-        if (swapchain_image_rendered_semaphores_size < swapchain_images_size) {
-            detail::logger->debug(
-                "window {}: creating image rendered semaphores ({} -> {})",
-                static_cast<void*>(_window_raw),
-                swapchain_image_rendered_semaphores_size,
-                swapchain_images_size
-            );
-            _window_swapchain_image_rendered_semaphores.reserve(swapchain_images_size);
-            std::ranges::transform(
-                std::views::iota(swapchain_image_rendered_semaphores_size, swapchain_images_size),
-                std::back_inserter(_window_swapchain_image_rendered_semaphores),
-                [this, &device](uint32_t) -> std::pair<vk::raii::Semaphore, GrBackendSemaphore> {
-                    auto vk_semaphore = device->createSemaphore({});
-                    GrBackendSemaphore skia_semaphore;
-                    skia_semaphore.initVulkan(*vk_semaphore);
-                    return {std::move(vk_semaphore), std::move(skia_semaphore)};
-                }
-            );
-            detail::logger->debug("window {}: created image rendered semaphores ({})", static_cast<void*>(_window_raw), _window_swapchain_image_rendered_semaphores.size());
-        }
         size_t swapchain_image_presentable_semaphores_size = _window_swapchain_image_presentable_semaphores.size();
         if (swapchain_image_presentable_semaphores_size < swapchain_images_size) {
             detail::logger->debug(
@@ -544,7 +851,23 @@ class Window:
             );
             detail::logger->debug("window {}: created image presentable semaphores ({})", static_cast<void*>(_window_raw), _window_swapchain_image_presentable_semaphores.size());
         }
-        max_frames_enqueued = swapchain_images_size - 1;
+        // new images have no content yet
+        _window_swapchain_image_damage.assign(swapchain_images_size, SkRegion{SkIRect::MakeWH(_window_swapchain_extent.x, _window_swapchain_extent.y)});
+        invalidate();
+        _incremental_present = std::ranges::any_of(
+            device.extensions(),
+            [](const char* extension) {
+                return std::strcmp(extension, "VK_KHR_incremental_present") == 0;
+            }
+        );
+        max_frames_enqueued = _frame_scheduler.frames_in_flight(swapchain_images_size);
+        if (_frame_fences.size() != max_frames_enqueued) {
+            // every fence is free after _retire_frames(true)
+            _frame_fences.clear();
+            _frame_fences.reserve(max_frames_enqueued);
+            for (size_t i = 0; i < max_frames_enqueued; i++) _frame_fences.emplace_back(device->createFence({}), false);
+        }
+        _frame_slot = 0;
         detail::logger->debug("window {}: max frames {}", static_cast<void*>(_window_raw), max_frames_enqueued);
     }
 
@@ -554,11 +877,32 @@ class Window:
     core::iVec2D _window_swapchain_extent;
     std::vector<VkImage> _window_swapchain_images;
     std::vector<std::pair<vk::raii::Semaphore, GrBackendSemaphore>> _window_swapchain_image_renderable_semaphores;
-    std::vector<std::pair<vk::raii::Semaphore, GrBackendSemaphore>> _window_swapchain_image_rendered_semaphores;
     std::vector<std::pair<vk::raii::Semaphore, GrBackendSemaphore>> _window_swapchain_image_presentable_semaphores;
     std::vector<GrBackendRenderTarget> _window_skia_backend_render_targets;
     std::vector<sk_sp<SkSurface>> _window_skia_surfaces;
+    // what each image is missing since it was last drawn
+    std::vector<SkRegion> _window_swapchain_image_damage;
+    // invalidated since the last present
+    SkRegion _pending_damage;
+    bool _damage_tracking = false;
+    bool _incremental_present = false;
+    // kept across frames to reuse its storage
+    std::vector<vk::RectLayerKHR> _present_rects;
+    // kept up to date by the glfw callbacks
+    bool _focused = true;
+    bool _minimized = false;
+    bool _visible = true;
+    core::iVec2D _framebuffer_size{};
+    std::optional<FrameScheduler::clock::duration> _unfocused_frame_interval;
     bool _run = true;
+    // signalled once the gpu is done with the frame submitted along with it, paired with whether it was submitted
+    std::vector<std::pair<vk::raii::Fence, bool>> _frame_fences;
+    size_t _frame_slot = 0;
+    FrameScheduler _frame_scheduler;
+    // the pacing mode changed since the swapchain was created
+    bool _swapchain_outdated = false;
+    // keeps presents after the first off the startup report lock
+    bool _first_frame_presented = false;
     size_t current_frames_enqueued = 0;
     size_t max_frames_enqueued = 0;
     uint32_t current_image = std::numeric_limits<uint32_t>::max();
@@ -566,6 +910,9 @@ class Window:
 }
 
 namespace tiara::wm {
+    using WindowEventRecorder = detail::Window::EventRecorderT;
+    using WindowEventReplayer = detail::Window::EventReplayerT;
+
 class Window: 
     public core::event::DelegatingSharedDispatcher<
         detail::Window,
@@ -592,15 +939,92 @@ class Window:
         return static_cast<GLFWwindow*>(*_window_detail);
     }
 
+    template <std::derived_from<core::event::Event> Ev>
+    bool post(const Ev& event) {
+        return _window_detail->post(event);
+    }
+    std::size_t dispatch_posted() {
+        return _window_detail->dispatch_posted();
+    }
+
+    template <std::derived_from<core::event::Event> Ev>
+    void set_coalesce_policy(core::event::CoalescePolicy policy) {
+        _window_detail->set_coalesce_policy<Ev>(policy);
+    }
+    std::size_t dispatch_coalesced() {
+        return _window_detail->dispatch_coalesced();
+    }
+
+    void start_recording(std::shared_ptr<detail::Window::EventRecorderT> recorder) {
+        _window_detail->start_recording(std::move(recorder));
+    }
+    void stop_recording() {
+        _window_detail->stop_recording();
+    }
+    template <std::derived_from<core::event::Event> Ev>
+    void replay(const Ev& event) {
+        _window_detail->replay(event);
+    }
+
     void draw() {
         _window_detail->draw();
     }
     void stop() {
         _window_detail->stop();
     }
+    bool running() const noexcept {
+        return _window_detail->running();
+    }
+
+    void show() {
+        _window_detail->show();
+    }
+    void hide() {
+        _window_detail->hide();
+    }
+    bool focused() const noexcept {
+        return _window_detail->focused();
+    }
+    bool minimized() const noexcept {
+        return _window_detail->minimized();
+    }
+    void set_unfocused_frame_rate(std::optional<double> fps) {
+        _window_detail->set_unfocused_frame_rate(fps);
+    }
+
+    void invalidate(const SkIRect& rect) {
+        _window_detail->invalidate(rect);
+    }
+    void invalidate() {
+        _window_detail->invalidate();
+    }
+    void set_damage_tracking(bool enabled) {
+        _window_detail->set_damage_tracking(enabled);
+    }
+    bool damage_tracking() const noexcept {
+        return _window_detail->damage_tracking();
+    }
+
+    void set_frame_pacing(FramePacing mode) {
+        _window_detail->set_frame_pacing(mode);
+    }
+    FrameScheduler& frame_scheduler() noexcept {
+        return _window_detail->frame_scheduler();
+    }
+    FrameScheduler::clock::time_point next_frame_start() const noexcept {
+        return _window_detail->next_frame_start();
+    }
     private:
     std::shared_ptr<detail::Window> _window_detail;
 };
+
+    /**
+     *  @brief draw windows when their frame schedulers want, handling glfw events while waiting, until every one is stopped
+     *
+     *  posted monitor events, then posted and coalesced window events are dispatched on every wakeup, whether or not a frame is due.
+     *  a window asked to close by glfw is stopped once the close event was dispatched without clearing the request.
+     */
+    inline void run(std::initializer_list<std::reference_wrapper<Window>> windows);
 }
 
 #include "tiara/wm/monitor.hpp"
@@ -639,6 +1063,9 @@ Window::Window(
     },
     _window_swapchain{nullptr}
 {
+    _focused = glfwGetWindowAttrib(_window_raw, GLFW_FOCUSED) == GLFW_TRUE;
+    _minimized = glfwGetWindowAttrib(_window_raw, GLFW_ICONIFIED) == GLFW_TRUE;
+    _visible = glfwGetWindowAttrib(_window_raw, GLFW_VISIBLE) == GLFW_TRUE;
     _register_glfw_callbacks();
     _recreate_swapchain();
 }
@@ -654,6 +1081,38 @@ Window::Window(
 {
     DelegatingSharedDispatcher::dispatcher() = _window_detail;
 }
+
+inline void run(std::initializer_list<std::reference_wrapper<Window>> windows) {
+    using clock = FrameScheduler::clock;
+    while (true) {
+        auto next_frame_start = clock::time_point::max();
+        bool any_running = false;
+        for (Window& window: windows) {
+            if (glfwWindowShouldClose(static_cast<GLFWwindow*>(window))) window.stop();
+            if (!window.running()) continue;
+            any_running = true;
+            next_frame_start = std::min(next_frame_start, window.next_frame_start());
+        }
+        if (!any_running) break;
+
+        auto now = clock::now();
+        if (next_frame_start == clock::time_point::max()) glfwWaitEvents();
+        else if (next_frame_start > now) glfwWaitEventsTimeout(std::chrono::duration<double>(next_frame_start - now).count());
+        else glfwPollEvents();
+
+        // before the schedule is looked at, handlers may invalidate or stop their window
+        MonitorEventDispatcher::dispatch_posted();
+        for (Window& window: windows) {
+            if (!window.running()) continue;
+            window.dispatch_posted();
+            window.dispatch_coalesced();
+        }
+        now = clock::now();
+        for (Window& window: windows) {
+            if (window.running() && window.next_frame_start() <= now) window.draw();
+        }
+    }
+}
 }
 
 #endif
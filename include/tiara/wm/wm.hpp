@@ -10,19 +10,25 @@ namespace tiara::wm {
             detail::logger->info("initializing tiara::wm");
             MonitorEventDispatcher::init();
             glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+            if (prewarm_device) detail::_start_prewarm();
             _init = true;
             detail::logger->info("initialized tiara::wm");
         }
         virtual void deinit() final {
             detail::logger->info("deinitializing tiara::wm");
+            detail::_wait_for_prewarm();
             if (skia_context) {
+                store_skia_pipeline_cache();
+                if (detail::skia_persistent_cache) {
+                    detail::logger->debug(
+                        "skia cache: {} hits, {} misses",
+                        detail::skia_persistent_cache->hits(), detail::skia_persistent_cache->misses()
+                    );
+                }
                 skia_context->releaseResourcesAndAbandonContext();
                 skia_context.reset();
             }
-            skia_vulkan_context.reset();
-            skia_vulkan_extensions.reset();
-            detail::_undeleted_semaphores.clear();
-            present_queue.reset();
+            detail::_release_device();
             preferred_physical_device = nullptr;
             MonitorEventDispatcher::deinit();
             _init = false;
@@ -0,0 +1,156 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/async_dispatcher.hpp"
+
+#include <chrono>
+#include <memory>
+#include <stop_token>
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+};
+
+struct SlowEventHandler: tiara::core::event::AsyncHandler<Event> {
+    SlowEventHandler(int function_num, std::chrono::milliseconds delay, bool result):
+        function_num{function_num},
+        delay{delay},
+        result{result}
+    {}
+
+    boost::asio::awaitable<bool, boost::asio::any_io_executor> handle(const Event& event) override {
+        spdlog::info("{} received event!", function_num);
+        boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor, delay};
+        co_await timer.async_wait(boost::asio::use_awaitable);
+        spdlog::info("{} finished handling event!", function_num);
+        co_return result;
+    }
+
+    int function_num;
+    std::chrono::milliseconds delay;
+    bool result;
+};
+
+struct CancellableEventHandler: tiara::core::event::AsyncHandler<Event> {
+    boost::asio::awaitable<bool, boost::asio::any_io_executor> handle(const Event& event) override {
+        return handle(event, std::stop_token{});
+    }
+
+    boost::asio::awaitable<bool, boost::asio::any_io_executor> handle(const Event& event, std::stop_token stop) override {
+        boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor};
+        for (int step = 1; step <= 10; step++) {
+            timer.expires_after(std::chrono::milliseconds{50});
+            co_await timer.async_wait(boost::asio::use_awaitable);
+            if (stop.stop_requested()) {
+                spdlog::info("7 gave up after {} steps!", step);
+                co_return false;
+            }
+        }
+        spdlog::info("7 finished all steps!");
+        co_return true;
+    }
+};
+
+struct SyncEventHandler: tiara::core::event::Handler<Event> {
+    SyncEventHandler(int function_num, bool result): function_num{function_num}, result{result} {}
+
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("{} handled event in place!", function_num);
+        return result;
+    }
+
+    int function_num;
+    bool result;
+};
+
+struct EventDispatcher: tiara::core::event::DefaultAsyncDispatcher<boost::asio::any_io_executor, Event> {
+    using tiara::core::event::DefaultAsyncDispatcher<boost::asio::any_io_executor, Event>::DefaultAsyncDispatcher;
+    using tiara::core::event::DefaultAsyncDispatcher<boost::asio::any_io_executor, Event>::dispatch;
+};
+
+struct UnsubscribingEventHandler: tiara::core::event::Handler<Event> {
+    UnsubscribingEventHandler(EventDispatcher& dispatcher, std::unique_ptr<SyncEventHandler>& victim): dispatcher{dispatcher}, victim{victim} {}
+
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("unsubscribing and destroying {}!", victim->function_num);
+        dispatcher.stop_dispatch(*victim);
+        victim.reset();
+        return false;
+    }
+
+    EventDispatcher& dispatcher;
+    std::unique_ptr<SyncEventHandler>& victim;
+};
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    boost::asio::thread_pool pool{4};
+    EventDispatcher dispatcher{pool.get_executor()};
+    SlowEventHandler handler_1{1, std::chrono::milliseconds{300}, false};
+    SlowEventHandler handler_2{2, std::chrono::milliseconds{200}, true};
+    SlowEventHandler handler_3{3, std::chrono::milliseconds{100}, false};
+    dispatcher.start_dispatch(handler_1);
+    dispatcher.start_dispatch(handler_2);
+    dispatcher.start_dispatch(handler_3);
+
+    EventDispatcher mixed_dispatcher{pool.get_executor()};
+    SyncEventHandler sync_handler_4{4, true};
+    mixed_dispatcher.start_dispatch(sync_handler_4);
+    mixed_dispatcher.start_dispatch(handler_3);
+
+    EventDispatcher sync_dispatcher{pool.get_executor()};
+    SyncEventHandler sync_handler_5{5, false};
+    sync_dispatcher.start_dispatch(sync_handler_4);
+    sync_dispatcher.start_dispatch(sync_handler_5);
+
+    EventDispatcher unsubscribing_dispatcher{pool.get_executor()};
+    auto sync_handler_6 = std::make_unique<SyncEventHandler>(6, true);
+    UnsubscribingEventHandler unsubscribing_handler{unsubscribing_dispatcher, sync_handler_6};
+    unsubscribing_dispatcher.start_dispatch(unsubscribing_handler);
+    unsubscribing_dispatcher.start_dispatch(*sync_handler_6);
+    unsubscribing_dispatcher.start_dispatch(sync_handler_5);
+
+    EventDispatcher cancelling_dispatcher{pool.get_executor()};
+    CancellableEventHandler cancellable_handler_7;
+    cancelling_dispatcher.start_dispatch(cancellable_handler_7);
+
+    boost::asio::io_context io_context;
+    boost::asio::co_spawn(
+        io_context,
+        [&dispatcher, &mixed_dispatcher, &sync_dispatcher, &unsubscribing_dispatcher, &cancelling_dispatcher]() -> boost::asio::awaitable<void> {
+            auto start = std::chrono::steady_clock::now();
+            auto consumed = co_await dispatcher.dispatch(Event{}, tiara::core::event::reducers::any_of{});
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            spdlog::info("any_of: {} in {}ms", consumed, elapsed.count()); // true in ~300ms, not ~600ms
+            auto count = co_await dispatcher.dispatch(Event{}, 0);
+            spdlog::info("sum: {}", count); // 1
+            auto first = co_await dispatcher.dispatch(Event{}, tiara::core::event::reducers::first_consumer{});
+            spdlog::info("first consumer: {}", first.value()); // 1
+            auto mixed = co_await mixed_dispatcher.dispatch(Event{}, 0);
+            spdlog::info("mixed sum: {}", mixed); // 1, 4 handled before 3 finishes
+            auto sync = co_await sync_dispatcher.dispatch(Event{}, tiara::core::event::reducers::first_consumer{});
+            spdlog::info("sync first consumer: {}", sync.value()); // 0, without leaving the io_context thread
+            auto unsubscribed = co_await unsubscribing_dispatcher.dispatch(Event{}, 0);
+            spdlog::info("sum after unsubscribing: {}", unsubscribed); // 0, 6 is neither called nor counted
+
+            start = std::chrono::steady_clock::now();
+            auto in_time = co_await dispatcher.dispatch(Event{}, 0, tiara::core::event::DispatchDeadline{std::chrono::milliseconds{250}});
+            elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+            spdlog::info("sum within deadline: {} in {}ms", in_time, elapsed.count()); // 1 in ~250ms, 1 is dropped
+            try {
+                co_await dispatcher.dispatch(
+                    Event{},
+                    tiara::core::event::reducers::any_of{},
+                    tiara::core::event::DispatchDeadline{std::chrono::milliseconds{50}, tiara::core::event::PartialResultPolicy::fail}
+                );
+            }
+            catch (const tiara::core::event::exceptions::DispatchDeadlineExceeded& e) {
+                spdlog::info("{}", e.what()); // 3 handlers missed the dispatch deadline
+            }
+            auto cancelled = co_await cancelling_dispatcher.dispatch(Event{}, 0, tiara::core::event::DispatchDeadline{std::chrono::milliseconds{120}});
+            spdlog::info("sum with a cancelled handler: {}", cancelled); // 0, then 7 gives up after 3 steps instead of running all 10
+        },
+        boost::asio::detached
+    );
+    io_context.run();
+    pool.join();
+}
@@ -0,0 +1,80 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/dispatcher.hpp"
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+    int value;
+};
+
+struct EventHandler: tiara::core::event::Handler<Event> {
+    EventHandler(int function_num): function_num{function_num} {}
+
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("{} received event {}!", function_num, event.value);
+        return false;
+    }
+
+    int function_num;
+};
+
+struct BatchEventHandler: EventHandler {
+    using EventHandler::EventHandler;
+
+    void handle_batch(std::span<const Event> events, tiara::core::event::sync_tag_t) override {
+        int sum = 0;
+        for (const Event& event: events) sum += event.value;
+        spdlog::info("{} received {} events summing to {}!", function_num, events.size(), sum);
+    }
+};
+
+struct EventDispatcher: tiara::core::event::DefaultDispatcher<Event> {
+    void emit(int value) {
+        spdlog::info("deferring {}!", value);
+        defer(Event{{}, value});
+    }
+
+    void flush() {
+        spdlog::info("flushed {} events!", flush_deferred());
+    }
+};
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    EventDispatcher dispatcher;
+    EventHandler handler_1{1};
+    BatchEventHandler handler_2{2};
+    dispatcher.start_dispatch(handler_1);
+    dispatcher.start_dispatch(handler_2);
+    dispatcher.flush(); // 0 events, no handler is called
+    dispatcher.emit(1);
+    dispatcher.emit(2);
+    dispatcher.emit(3);
+    dispatcher.flush(); // 1 receives 1 2 3 one by one, 2 receives 3 events summing to 6
+    auto handler_3 = tiara::core::event::make_function_handler<Event>(
+        [&dispatcher](const Event& event) {
+            spdlog::info("3 received event {}, deferring {}!", event.value, event.value * 10);
+            dispatcher.emit(event.value * 10);
+            return false;
+        }
+    );
+    dispatcher.start_dispatch(handler_3);
+    dispatcher.emit(4);
+    dispatcher.flush(); // 1 2 3 receive 4, 40 is kept for the next flush
+    dispatcher.stop_dispatch(handler_3);
+    dispatcher.flush(); // 1 2 receive 40
+    auto handler_4 = tiara::core::event::make_function_handler<Event>(
+        [&dispatcher](const Event& event) {
+            if (event.value == 5) {
+                dispatcher.emit(50);
+                dispatcher.flush(); // 1 2 4 receive 50 only
+            }
+            return false;
+        }
+    );
+    dispatcher.start_dispatch(handler_4);
+    dispatcher.emit(5);
+    dispatcher.emit(6);
+    dispatcher.flush(); // 2 events, 1 receives 5 6, 2 receives 2 events summing to 11, then 4 flushes 50 mid batch
+    dispatcher.flush(); // 0 events
+}
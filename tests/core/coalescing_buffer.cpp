@@ -0,0 +1,60 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/coalesce.hpp"
+
+struct ScrollEvent: tiara::core::event::Event {
+    using RetType = bool;
+
+    double x_offset;
+    double y_offset;
+};
+
+template <>
+struct tiara::core::event::EventMerger<ScrollEvent> {
+    static void merge(ScrollEvent& accumulated, const ScrollEvent& next) {
+        accumulated.x_offset += next.x_offset;
+        accumulated.y_offset += next.y_offset;
+    }
+};
+
+struct KeyEvent: tiara::core::event::Event {
+    using RetType = bool;
+
+    int key;
+};
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+
+    tiara::core::event::CoalescingBuffer<ScrollEvent> scrolls;
+    spdlog::info("immediate buffered: {}", scrolls.push({{}, 1.0, 0.0})); // false
+    scrolls.set_policy(tiara::core::event::CoalescePolicy::accumulate);
+    scrolls.push({{}, 1.0, 0.5});
+    scrolls.push({{}, 2.0, -1.5});
+    scrolls.push({{}, 0.5, 3.0});
+    auto merged = scrolls.flush([](const ScrollEvent& event) {
+        spdlog::info("scrolled by {}, {}", event.x_offset, event.y_offset); // 3.5, 2
+    });
+    spdlog::info("flushed {} merged scroll events", merged); // 1
+    spdlog::info("empty after flush: {}", scrolls.empty()); // true
+
+    tiara::core::event::CoalescingBuffer<KeyEvent> keys;
+    keys.set_policy(tiara::core::event::CoalescePolicy::accumulate);
+    keys.push({{}, 1});
+    keys.push({{}, 2});
+    auto kept = keys.flush([&keys](const KeyEvent& event) {
+        spdlog::info("key {}", event.key); // 1 2
+        if (event.key == 2) keys.push({{}, 3});
+    });
+    spdlog::info("flushed {} key events", kept); // 2, 3 is kept for the next flush
+    keys.flush_batch([](std::span<const KeyEvent> events) {
+        spdlog::info("batch of {} starting with key {}", events.size(), events.front().key); // 1 starting with key 3
+    });
+
+    keys.set_policy(tiara::core::event::CoalescePolicy::latest_wins);
+    keys.push({{}, 4});
+    keys.push({{}, 5});
+    keys.flush([](const KeyEvent& event) {
+        spdlog::info("latest key {}", event.key); // 5
+    });
+}
@@ -0,0 +1,52 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/utilities/disk_cache.hpp"
+
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string_view>
+
+std::span<const std::byte> bytes_of(std::string_view s) {
+    return std::as_bytes(std::span{s.data(), s.size()});
+}
+
+std::string_view string_of(const std::vector<std::byte>& bytes) {
+    return {reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+}
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    auto directory = std::filesystem::temp_directory_path() / "tiara_disk_cache_test";
+    std::filesystem::remove_all(directory);
+    {
+        tiara::core::utils::DiskCache cache{directory, 4096};
+        spdlog::info("miss: {}", cache.load(bytes_of("pipeline")).has_value()); // false
+        cache.store(bytes_of("pipeline"), bytes_of("compiled pipeline"));
+        spdlog::info("hit: {}", string_of(cache.load(bytes_of("pipeline")).value())); // compiled pipeline
+    }
+    {
+        // a new instance, as in the next process start
+        tiara::core::utils::DiskCache cache{directory, 4096};
+        spdlog::info("size: {}", cache.size()); // 49
+        spdlog::info("warm hit: {}", string_of(cache.load(bytes_of("pipeline")).value())); // compiled pipeline
+
+        std::string large(1000, 'x');
+        for (char c = 'a'; c <= 'h'; c++) cache.store(bytes_of(std::string(1, c)), bytes_of(large));
+        spdlog::info("size within cap: {}", cache.size() <= cache.max_bytes()); // true
+        spdlog::info("newest kept: {}", cache.load(bytes_of("h")).has_value()); // true
+        spdlog::info("oldest evicted: {}", cache.load(bytes_of("a")).has_value()); // false
+    }
+    {
+        // claim an absurd data size in every entry, as a corrupt file would
+        for (auto& entry: std::filesystem::directory_iterator{directory}) {
+            std::fstream stream{entry.path(), std::ios::binary | std::ios::in | std::ios::out};
+            uint64_t data_size = UINT64_MAX / 2;
+            stream.seekp(offsetof(tiara::core::utils::detail::DiskCacheEntryHeader, data_size));
+            stream.write(reinterpret_cast<const char*>(&data_size), sizeof(data_size));
+        }
+        tiara::core::utils::DiskCache cache{directory, 4096};
+        spdlog::info("corrupt entry hit: {}", cache.load(bytes_of("h")).has_value()); // false, without allocating
+    }
+    std::filesystem::remove_all(directory);
+}
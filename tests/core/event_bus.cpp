@@ -0,0 +1,74 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/event_bus.hpp"
+
+#include <cstring>
+
+struct KeyEvent: tiara::core::event::Event {
+    using RetType = bool;
+    int key;
+};
+
+struct ResizeEvent: tiara::core::event::Event {
+    using RetType = bool;
+    int width;
+    int height;
+};
+
+struct KeyEventHandler: tiara::core::event::Handler<KeyEvent> {
+    bool handle(const KeyEvent& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("key {}!", event.key);
+        return event.key == 0;
+    }
+};
+
+struct ResizeEventHandler: tiara::core::event::Handler<ResizeEvent> {
+    bool handle(const ResizeEvent& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("resize to {}x{}!", event.width, event.height);
+        return false;
+    }
+};
+
+struct ScrollEventHandler: tiara::core::event::Handler<tiara::core::event::DynamicEvent> {
+    bool handle(const tiara::core::event::DynamicEvent& event, tiara::core::event::sync_tag_t) override {
+        double offset;
+        std::memcpy(&offset, event.payload.data(), sizeof(offset));
+        spdlog::info("{} by {}!", tiara::core::event::event_type_info(event.type).name, offset);
+        return true;
+    }
+};
+
+struct EventBus: tiara::core::event::EventBus {
+    using tiara::core::event::EventBus::dispatch;
+};
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    EventBus bus;
+    KeyEventHandler key_handler;
+    ResizeEventHandler resize_handler;
+    ScrollEventHandler scroll_handler;
+
+    bus.start_dispatch(key_handler);
+    auto resize_subscription = bus.subscribe(resize_handler);
+    spdlog::info("consumed: {}", bus.dispatch(KeyEvent{{}, 0}, tiara::core::event::reducers::any_of{})); // key 0, true
+    spdlog::info("consumed: {}", bus.dispatch(ResizeEvent{{}, 640, 480}, tiara::core::event::reducers::any_of{})); // resize to 640x480, false
+
+    auto scroll = tiara::core::event::register_event_type("scroll", sizeof(double));
+    bus.subscribe(scroll, scroll_handler);
+    double offset = 2.5;
+    tiara::core::event::DynamicEvent scroll_event{{}, scroll, std::as_bytes(std::span{&offset, 1})};
+    spdlog::info("consumed: {}", bus.dispatch(scroll_event, tiara::core::event::reducers::any_of{})); // scroll by 2.5, true
+
+    bus.unsubscribe(resize_subscription);
+    bus.stop_dispatch(key_handler);
+    spdlog::info("handlers: {} {} {}", bus.handler_count<KeyEvent>(), bus.handler_count<ResizeEvent>(), bus.handler_count(scroll)); // 0 0 1
+    spdlog::info("consumed: {}", bus.dispatch(KeyEvent{{}, 0}, tiara::core::event::reducers::any_of{})); // false
+
+    try {
+        bus.subscribe(tiara::core::event::event_type_id<KeyEvent>(), scroll_handler);
+    }
+    catch (const tiara::core::event::exceptions::EventTypeMismatch& e) {
+        spdlog::info("{}", e.what()); // handler does not match event type 8KeyEvent
+    }
+}
@@ -0,0 +1,89 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/dispatcher.hpp"
+#include "tiara/core/event/record.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+struct MoveEvent: tiara::core::event::Event {
+    using RetType = bool;
+    int x;
+    int y;
+};
+
+struct CloseEvent: tiara::core::event::Event {
+    using RetType = bool;
+};
+
+struct EventHandler: tiara::core::event::Handler<MoveEvent>, tiara::core::event::Handler<CloseEvent> {
+    bool handle(const MoveEvent& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("moved to ({}, {})!", event.x, event.y);
+        return false;
+    }
+    bool handle(const CloseEvent& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("closed!");
+        return false;
+    }
+};
+
+struct EventDispatcher: tiara::core::event::DefaultDispatcher<MoveEvent, CloseEvent> {
+    template <typename Ev>
+    void emit(const Ev& event) {
+        dispatch(event, tiara::core::event::reducers::any_of{});
+    }
+};
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    auto path = (std::filesystem::temp_directory_path() / "tiara_event_record_test.bin").string();
+    {
+        tiara::core::event::EventRecorder<MoveEvent, CloseEvent> recorder{path};
+        recorder.record(MoveEvent{{}, 1, 2});
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        recorder.record(MoveEvent{{}, 3, 4});
+        recorder.record(CloseEvent{});
+        spdlog::info("recorded {} events", recorder.recorded()); // 3
+    }
+
+    EventDispatcher dispatcher;
+    EventHandler handler;
+    dispatcher.start_dispatch(static_cast<tiara::core::event::Handler<MoveEvent>&>(handler));
+    dispatcher.start_dispatch(static_cast<tiara::core::event::Handler<CloseEvent>&>(handler));
+    auto emit = [&dispatcher](const auto& event){ dispatcher.emit(event); };
+
+    tiara::core::event::EventReplayer<MoveEvent, CloseEvent> fast_replayer{path};
+    spdlog::info("replaying at maximum speed");
+    spdlog::info("replayed {} events", fast_replayer.replay(emit)); // (1, 2) (3, 4) closed, 3 events
+
+    tiara::core::event::EventReplayer<MoveEvent, CloseEvent> stepped_replayer{path};
+    spdlog::info("replaying first 25 ms");
+    stepped_replayer.replay_until(std::chrono::milliseconds(25), emit); // (1, 2)
+    spdlog::info("replaying the rest at original speed");
+    auto time_before = std::chrono::steady_clock::now();
+    stepped_replayer.replay(emit, tiara::core::event::ReplaySpeed::original); // (3, 4) closed
+    spdlog::info(
+        "took at least 25 ms: {}", // true, the second event was recorded 50 ms after the first
+        std::chrono::steady_clock::now() - time_before >= std::chrono::milliseconds(25)
+    );
+
+    try {
+        tiara::core::event::EventReplayer<CloseEvent, MoveEvent> mismatched_replayer{path};
+    } catch (const tiara::core::event::exceptions::EventLogError& error) {
+        spdlog::info("{}", error.what()); // event log was recorded with different event types
+    }
+
+    {
+        std::fstream corrupted{path, std::ios::binary | std::ios::in | std::ios::out};
+        corrupted.seekp(sizeof(tiara::core::event::detail::EventLogHeader<MoveEvent, CloseEvent>));
+        corrupted.put(char{7});
+    }
+    try {
+        tiara::core::event::EventReplayer<MoveEvent, CloseEvent> corrupted_replayer{path};
+    } catch (const tiara::core::event::exceptions::EventLogError& error) {
+        spdlog::info("{}", error.what()); // unknown event tag
+    }
+    std::filesystem::remove(path);
+}
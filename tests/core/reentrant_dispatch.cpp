@@ -0,0 +1,73 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/managed_handler.hpp"
+
+#include <functional>
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+};
+
+struct EventDispatcher: tiara::core::event::DefaultDispatcher<Event> {
+    void emit() {
+        spdlog::info("emitting!");
+        dispatch(Event{}, 0);
+    }
+};
+
+struct EventHandler: tiara::core::event::Handler<Event> {
+    EventHandler(int function_num, std::function<void()> on_event = {}): function_num{function_num}, on_event{std::move(on_event)} {}
+
+    ~EventHandler() override {
+        spdlog::info("{} destroyed!", function_num);
+    }
+
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("{} received event!", function_num);
+        if (on_event) on_event();
+        return false;
+    }
+
+    int function_num;
+    std::function<void()> on_event;
+};
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    auto dispatcher = std::make_shared<EventDispatcher>();
+    bool nested = false;
+
+    EventHandler handler_4{4};
+    auto handler_3 = std::make_shared<tiara::core::event::ManagedHandler<Event, boost::asio::any_io_executor, EventHandler>>(3);
+    EventHandler handler_2{
+        2,
+        [&](){
+            if (handler_3) {
+                spdlog::info("destroying 3 during dispatch");
+                handler_3.reset();
+            }
+        }
+    };
+    EventHandler handler_1{1};
+    handler_1.on_event = [&](){
+        spdlog::info("1 unsubscribing itself and subscribing 4 during dispatch");
+        dispatcher->stop_dispatch(handler_1);
+        dispatcher->start_dispatch(handler_4);
+    };
+    EventHandler handler_5{
+        5,
+        [&](){
+            if (!nested) {
+                nested = true;
+                dispatcher->emit(); // 2 5 4, nested dispatch already sees handler 4
+            }
+        }
+    };
+
+    dispatcher->start_dispatch(handler_1);
+    dispatcher->start_dispatch(handler_2);
+    handler_3->subscribe(dispatcher);
+    dispatcher->start_dispatch(handler_5);
+    dispatcher->emit(); // 1 2 5 (2 5 4), 3 is destroyed before being called and 4 only receives the nested dispatch
+    dispatcher->emit(); // 2 5 4, removed handlers were compacted in order once the outer dispatch returned
+}
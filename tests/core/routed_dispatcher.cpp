@@ -0,0 +1,64 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/routed_dispatcher.hpp"
+#include "tiara/core/utilities/predicate_combinators.hpp"
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+    int target;
+    int value;
+};
+
+struct EventHandler: tiara::core::event::Handler<Event> {
+    EventHandler(int function_num): function_num{function_num} {}
+
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("{} received event for {} with value {}!", function_num, event.target, event.value);
+        return false;
+    }
+
+    int function_num;
+};
+
+struct TargetOf {
+    int operator()(const Event& event) const {
+        return event.target;
+    }
+};
+
+struct EventDispatcher: tiara::core::event::RoutedDispatcher<Event, int, TargetOf> {
+    void emit(int target, int value) {
+        spdlog::info("emitting for {} with value {}!", target, value);
+        dispatch(Event{{}, target, value}, 0);
+    }
+};
+
+using preds = tiara::core::utils::preds::combinators<const Event&>;
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    EventHandler handler_1{1};
+    EventHandler handler_2{2};
+    EventHandler handler_3{3};
+    EventHandler handler_4{4};
+    EventDispatcher dispatcher;
+    dispatcher.start_dispatch(handler_1);
+    auto subscription_2 = dispatcher.subscribe(handler_2, 0);
+    dispatcher.subscribe(handler_3, 1);
+    dispatcher.subscribe(
+        handler_4, 1,
+        preds::make_and_(
+            [](const Event& event){ return event.value > 0; },
+            [](const Event& event){ return event.value % 2 == 0; }
+        )
+    );
+    dispatcher.emit(0, 1); // 1 2
+    dispatcher.emit(1, 1); // 1 3
+    dispatcher.emit(1, 2); // 1 3 4
+    dispatcher.emit(2, 2); // 1
+    spdlog::info("unsubscribing 2: {}", dispatcher.unsubscribe(subscription_2)); // true
+    spdlog::info("unsubscribing 2 again: {}", dispatcher.unsubscribe(subscription_2)); // false
+    dispatcher.emit(0, 1); // 1
+    dispatcher.stop_dispatch(handler_3);
+    dispatcher.emit(1, 4); // 1 4
+}
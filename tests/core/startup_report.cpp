@@ -0,0 +1,41 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/startup.hpp"
+
+#include <thread>
+
+int main() {
+    spdlog::set_pattern("%Y-%m-%d %T.%e %n [%t] %^%l:%$ %v");
+    auto& report = tiara::core::detail::startup_report;
+    report.restart();
+    {
+        auto outer = report.time("outer");
+        {
+            auto inner = report.time("inner");
+            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+        }
+        for (int i = 0; i < 3; i++) {
+            // only the first is recorded
+            auto once = report.time_once("once");
+        }
+        std::thread{[&report](){
+            // another thread starts at depth 0
+            auto other = report.time("other thread");
+        }}.join();
+        report.mark("mark");
+        report.mark_once("first");
+        report.mark_once("first");
+    }
+    auto running = report.time("running");
+    tiara::core::log_startup_report(*spdlog::default_logger(), report);
+    // outer: ...
+    //   inner: ...
+    //   once: ...
+    // other thread: ...
+    //   mark
+    //   first
+    // running (running)
+    spdlog::info("phases: {}", report.phases().size()); // phases: 7
+    spdlog::info("inner depth: {}", report.find("inner")->depth); // inner depth: 1
+    spdlog::info("inner at least 2ms: {}", report.find("inner")->duration >= std::chrono::milliseconds{2}); // inner at least 2ms: true
+}
@@ -0,0 +1,65 @@
+#define TIARA_ENABLE_EVENT_STATISTICS 1
+
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/dispatcher.hpp"
+
+#include <chrono>
+#include <thread>
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+    int value;
+};
+
+struct FastEventHandler: tiara::core::event::Handler<Event> {
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        return false;
+    }
+};
+
+struct SlowEventHandler: tiara::core::event::Handler<Event> {
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return event.value % 2 == 0;
+    }
+};
+
+struct EventDispatcher: tiara::core::event::DefaultDispatcher<Event> {
+    void emit(int value) {
+        dispatch(Event{{}, value}, tiara::core::event::reducers::any_of{});
+    }
+};
+
+struct SelfUnsubscribingEventHandler: tiara::core::event::Handler<Event> {
+    SelfUnsubscribingEventHandler(EventDispatcher& dispatcher): dispatcher{dispatcher} {}
+
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        dispatcher.stop_dispatch(*this);
+        return false;
+    }
+
+    EventDispatcher& dispatcher;
+};
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    EventDispatcher dispatcher;
+    SlowEventHandler slow_handler;
+    FastEventHandler fast_handler;
+    dispatcher.start_dispatch(slow_handler);
+    dispatcher.start_dispatch(fast_handler);
+    for (int i = 0; i < 10; i++) dispatcher.emit(i);
+    // 10 dispatches, 15 handler calls, 2 handlers subscribed
+    // slow handler: 10 calls, p50 at least 1000000 ns
+    // fast handler: 5 calls, only odd events are not consumed by the slow handler
+    for (const auto& snapshot: dispatcher.statistics_snapshot()) tiara::core::event::log_statistics(*spdlog::default_logger(), snapshot);
+    dispatcher.reset_statistics();
+    spdlog::info("dispatches after reset: {}", dispatcher.statistics<Event>().dispatches()); // 0
+    dispatcher.stop_dispatch(slow_handler);
+    spdlog::info("handlers listed after unsubscribing: {}", dispatcher.statistics_snapshot()[0].handlers.size()); // 1
+    SelfUnsubscribingEventHandler self_unsubscribing_handler{dispatcher};
+    dispatcher.start_dispatch(self_unsubscribing_handler);
+    dispatcher.emit(1);
+    spdlog::info("handlers listed after self unsubscription: {}", dispatcher.statistics_snapshot()[0].handlers.size()); // 1
+}
@@ -0,0 +1,49 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/dispatcher.hpp"
+
+struct Event: tiara::core::event::Event {
+    using RetType = bool;
+};
+
+struct EventHandler: tiara::core::event::Handler<Event> {
+    EventHandler(int function_num): function_num{function_num} {}
+
+    bool handle(const Event& event, tiara::core::event::sync_tag_t) override {
+        spdlog::info("{} received event!", function_num);
+        return false;
+    }
+
+    int function_num;
+};
+
+struct EventDispatcher: tiara::core::event::DefaultDispatcher<Event> {
+    void emit() {
+        spdlog::info("emitting!");
+        dispatch(Event{}, 0);
+    }
+};
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    EventHandler handler_1{1};
+    EventHandler handler_2{2};
+    EventHandler handler_3{3};
+    EventDispatcher dispatcher;
+    auto subscription_1 = dispatcher.subscribe(handler_1);
+    auto subscription_2 = dispatcher.subscribe(handler_2);
+    dispatcher.start_dispatch(handler_3);
+    dispatcher.emit(); // 1 2 3
+    spdlog::info("unsubscribing 1: {}", dispatcher.unsubscribe(subscription_1)); // true
+    dispatcher.emit(); // 2 3
+    spdlog::info("unsubscribing 1 again: {}", dispatcher.unsubscribe(subscription_1)); // false
+    auto subscription_1_again = dispatcher.subscribe(handler_1);
+    spdlog::info("old subscription of 1 is subscribed: {}", dispatcher.is_subscribed(subscription_1)); // false, slot reused with a new generation
+    spdlog::info("new subscription of 1 is subscribed: {}", dispatcher.is_subscribed(subscription_1_again)); // true
+    dispatcher.emit(); // 2 3 1
+    dispatcher.stop_dispatch(handler_3);
+    dispatcher.emit(); // 2 1
+    dispatcher.stop_dispatch(handler_2);
+    spdlog::info("subscription of 2 is subscribed: {}", dispatcher.is_subscribed(subscription_2)); // false
+    dispatcher.emit(); // 1
+}
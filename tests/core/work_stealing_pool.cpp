@@ -0,0 +1,59 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/core/event/async_dispatcher.hpp"
+#include "tiara/core/task/pool.hpp"
+
+#include <atomic>
+#include <future>
+
+struct Event: tiara::core::event::Event {
+    using RetType = int;
+    int value;
+};
+
+using Executor = tiara::core::task::WorkStealingPool::executor_type;
+
+struct EventHandler: tiara::core::event::AsyncHandler<Event, Executor> {
+    boost::asio::awaitable<int, Executor> handle(const Event& event) override {
+        co_return event.value * 2;
+    }
+};
+
+struct EventDispatcher: tiara::core::event::DefaultAsyncDispatcher<Executor, Event> {
+    using tiara::core::event::DefaultAsyncDispatcher<Executor, Event>::DefaultAsyncDispatcher;
+    using tiara::core::event::DefaultAsyncDispatcher<Executor, Event>::dispatch;
+};
+
+// each task spawns two children until depth reaches 0, so most tasks are submitted from workers and stolen
+void spawn_tree(tiara::core::task::WorkStealingPool& pool, int depth, std::atomic<int>& count) {
+    count.fetch_add(1, std::memory_order_relaxed);
+    if (depth == 0) return;
+    pool.submit([&pool, depth, &count](){ spawn_tree(pool, depth - 1, count); });
+    pool.submit([&pool, depth, &count](){ spawn_tree(pool, depth - 1, count); });
+}
+
+int main() {
+    spdlog::set_pattern("[%Y-%m-%d %T.%e] [logger %n] [thread %t] [%^%l%$] %v");
+    std::atomic<int> count{0};
+    {
+        tiara::core::task::WorkStealingPool pool{4};
+        pool.submit([&pool, &count](){ spawn_tree(pool, 15, count); });
+        pool.join();
+        spdlog::info("ran {} tasks", count.load()); // 65535
+
+        tiara::core::task::WorkStealingPool coroutine_pool{4};
+        EventDispatcher dispatcher{coroutine_pool.get_executor()};
+        EventHandler handler_1, handler_2;
+        dispatcher.start_dispatch(handler_1);
+        dispatcher.start_dispatch(handler_2);
+        std::promise<int> result;
+        boost::asio::co_spawn(
+            coroutine_pool.get_executor(),
+            [&dispatcher]() -> boost::asio::awaitable<int, Executor> {
+                co_return co_await dispatcher.dispatch(Event{{}, 21}, 0);
+            },
+            [&result](std::exception_ptr, int value){ result.set_value(value); }
+        );
+        spdlog::info("dispatched on the pool: {}", result.get_future().get()); // 84
+    }
+}
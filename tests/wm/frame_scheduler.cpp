@@ -0,0 +1,53 @@
+#include "spdlog/spdlog.h"
+
+#include "tiara/wm/frame_scheduler.hpp"
+
+#include <chrono>
+
+using namespace std::chrono_literals;
+
+int main() {
+    spdlog::set_pattern("%Y-%m-%d %T.%e %n [%t] %^%l:%$ %v");
+    using tiara::wm::FramePacing;
+    using clock = tiara::wm::FrameScheduler::clock;
+
+    tiara::wm::FrameScheduler scheduler;
+    scheduler.set_refresh_rate(100);
+    auto now = clock::time_point{} + 1s;
+    spdlog::info("first frame right away: {}", scheduler.next_frame_start() == clock::time_point::min()); // first frame right away: true
+
+    // 2ms frames presented every 10ms
+    for (int i = 0; i < 10; i++) {
+        scheduler.frame_started(now);
+        scheduler.frame_presented(now + 2ms);
+        now += 10ms;
+    }
+    auto last_present = now - 10ms + 2ms;
+    spdlog::info("frame time: {}us", std::chrono::duration_cast<std::chrono::microseconds>(scheduler.frame_time()).count()); // frame time: 2000us
+    spdlog::info("present interval: {}us", std::chrono::duration_cast<std::chrono::microseconds>(scheduler.present_interval()).count()); // present interval: 10000us
+    // 10ms after the last present, less the 2ms frame and 1ms margin
+    spdlog::info(
+        "low latency start after last present: {}us",
+        std::chrono::duration_cast<std::chrono::microseconds>(scheduler.next_frame_start() - last_present).count()
+    ); // low latency start after last present: 7000us
+
+    scheduler.set_mode(FramePacing::throughput);
+    spdlog::info("throughput right away: {}", scheduler.next_frame_start() == clock::time_point::min()); // throughput right away: true
+    spdlog::info("throughput images: {}, frames: {}", scheduler.swapchain_image_count(2, 0), scheduler.frames_in_flight(4)); // throughput images: 4, frames: 3
+
+    scheduler.set_mode(FramePacing::power_saving);
+    scheduler.set_frame_rate_cap(20);
+    auto last_start = now - 10ms;
+    spdlog::info(
+        "power saving start after last start: {}us",
+        std::chrono::duration_cast<std::chrono::microseconds>(scheduler.next_frame_start() - last_start).count()
+    ); // power saving start after last start: 50000us
+    spdlog::info("power saving images: {}, frames: {}", scheduler.swapchain_image_count(2, 3), scheduler.frames_in_flight(2)); // power saving images: 2, frames: 1
+
+    // a cap above the refresh rate is held to it
+    scheduler.set_frame_rate_cap(1000);
+    spdlog::info(
+        "capped to refresh: {}us",
+        std::chrono::duration_cast<std::chrono::microseconds>(scheduler.next_frame_start() - last_start).count()
+    ); // capped to refresh: 10000us
+}